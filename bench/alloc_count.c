@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include <string.h>
+#include "alloc_count.h"
+
+static size_t g_allocs, g_frees, g_bytes, g_peak, g_live_at_reset;
+static int64_t g_live;   // usable bytes currently allocated
+
+#ifdef BENCH_COUNT_ALLOCS
+#include <malloc.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+void __real_free(void *p);
+
+// Sizes come from malloc_usable_size, so blocks allocated inside libc and
+// released by us are accounted for consistently.
+static void account(int64_t delta, size_t requested, int is_alloc) {
+    if (is_alloc) {
+        __atomic_fetch_add(&g_allocs, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&g_bytes, requested, __ATOMIC_RELAXED);
+    }
+    int64_t live = __atomic_add_fetch(&g_live, delta, __ATOMIC_RELAXED);
+    size_t cur = live > 0 ? (size_t)live : 0;
+    size_t peak = __atomic_load_n(&g_peak, __ATOMIC_RELAXED);
+    while (cur > peak && !__atomic_compare_exchange_n(&g_peak, &peak, cur, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void *__wrap_malloc(size_t size) {
+    void *p = __real_malloc(size);
+    if (p) account((int64_t)malloc_usable_size(p), size, 1);
+    return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    void *p = __real_calloc(n, size);
+    if (p) account((int64_t)malloc_usable_size(p), n * size, 1);
+    return p;
+}
+
+void *__wrap_realloc(void *old, size_t size) {
+    int64_t before = old ? (int64_t)malloc_usable_size(old) : 0;
+    void *p = __real_realloc(old, size);
+    if (p) account((int64_t)malloc_usable_size(p) - before, size, 1);
+    else if (size == 0 && old) account(-before, 0, 0);
+    return p;
+}
+
+void __wrap_free(void *p) {
+    if (!p) return;
+    __atomic_fetch_add(&g_frees, 1, __ATOMIC_RELAXED);
+    account(-(int64_t)malloc_usable_size(p), 0, 0);
+    __real_free(p);
+}
+#endif
+
+/**
+ * Indique si les allocations sont comptées dans ce binaire.
+ * @return 1 si oui, 0 sinon.
+ */
+int alloc_count_enabled(void) {
+#ifdef BENCH_COUNT_ALLOCS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Remet les compteurs à zéro.
+ * @return Aucun.
+ */
+void alloc_count_reset(void) {
+    int64_t live = __atomic_load_n(&g_live, __ATOMIC_RELAXED);
+    g_live_at_reset = live > 0 ? (size_t)live : 0;
+    __atomic_store_n(&g_allocs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_frees, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_peak, g_live_at_reset, __ATOMIC_RELAXED);
+}
+
+/**
+ * Lit les compteurs.
+ * @param out Sortie: compteurs depuis la dernière remise à zéro.
+ * @return Aucun.
+ */
+void alloc_count_get(AllocStats *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    out->allocs = __atomic_load_n(&g_allocs, __ATOMIC_RELAXED);
+    out->frees = __atomic_load_n(&g_frees, __ATOMIC_RELAXED);
+    out->bytes = __atomic_load_n(&g_bytes, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&g_peak, __ATOMIC_RELAXED);
+    // Report the peak above what was already live at the reset
+    out->peak = peak > g_live_at_reset ? peak - g_live_at_reset : 0;
+}
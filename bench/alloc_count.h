@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+
+// Compteurs d'allocations du tas (actifs si BENCH_COUNT_ALLOCS: l'éditeur
+// de liens redirige malloc/calloc/realloc/free vers alloc_count.c).
+typedef struct AllocStats {
+    size_t allocs;       // appels malloc/calloc/realloc depuis la remise à zéro
+    size_t frees;        // appels free (pointeur non nul)
+    size_t bytes;        // octets demandés
+    size_t peak;         // pic d'octets vivants (depuis la remise à zéro)
+} AllocStats;
+
+/**
+ * Indique si les allocations sont comptées dans ce binaire.
+ * @return 1 si oui, 0 sinon (les compteurs restent à zéro).
+ */
+int alloc_count_enabled(void);
+
+/**
+ * Remet les compteurs à zéro; le pic repart des octets vivants actuels.
+ * @return Aucun.
+ */
+void alloc_count_reset(void);
+
+/**
+ * Lit les compteurs.
+ * @param out Sortie: compteurs depuis la dernière remise à zéro.
+ * @return Aucun.
+ */
+void alloc_count_get(AllocStats *out);
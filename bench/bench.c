@@ -0,0 +1,438 @@
+// Benchmarks of loading and inference over synthetic knowledge bases
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "alloc_count.h"
+#include "backward.h"
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+#include "kbgen.h"
+#include "loader.h"
+#include "stratify.h"
+#include "symbol.h"
+
+#define MAX_SIZES 32
+
+// Engines measured: the list-based reference and the compiled ones
+typedef enum BenchEngine {
+    BENCH_NAIVE = 0,     // inference_forward_chain sur les listes de la BC
+    BENCH_COMPILED,      // chaînage naïf sur la base compilée
+    BENCH_AGENDA,
+    BENCH_STRATIFIED,
+    BENCH_BACKWARD,      // chaînage arrière vers le dernier fait déduit
+    BENCH_ENGINE_COUNT
+} BenchEngine;
+
+static const char *const ENGINE_NAMES[BENCH_ENGINE_COUNT] = { "naive", "compiled", "agenda", "stratified", "backward" };
+
+typedef struct BenchOptions {
+    int shapes[KB_SHAPE_COUNT];
+    size_t sizes[MAX_SIZES];
+    size_t nsizes;
+    int engines[BENCH_ENGINE_COUNT];
+    int repeat;
+    uint64_t seed;
+    int json;
+    const char *out_path;
+} BenchOptions;
+
+// One line of results: a knowledge base run through one engine
+typedef struct BenchRow {
+    const char *shape;
+    size_t size;
+    size_t rules;
+    size_t symbols;
+    size_t premises;
+    const char *engine;
+    const char *status;     // "ok", "rejected" (base refused), "differs"/"mismatch" (see bench_kb)
+    double load_ms;         // loader_load_text, mean over the repeats
+    double compile_ms;      // bc_compile, mean over the repeats
+    size_t load_allocs;
+    double mean_us, min_us, p50_us, p95_us;
+    double runs_per_s;
+    double rules_per_s;
+    size_t facts_in;
+    size_t facts_out;
+    double allocs_per_run;
+    double bytes_per_run;
+    size_t peak_bytes;      // heap high-water mark above the base, worst run
+    long maxrss_kb;         // process high-water mark so far
+} BenchRow;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static long maxrss_kb(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return ru.ru_maxrss;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Affiche l'aide.
+ * @param prog Nom du programme.
+ * @return Aucun.
+ */
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --shapes LIST    chain,fanin,dag,neg,example,negorder (default: all)\n"
+            "  --sizes LIST     rule counts, e.g. 1000,10000 (default: 1000,10000)\n"
+            "  --engines LIST   naive,compiled,agenda,stratified,backward (default: all)\n"
+            "  --repeat N       timed runs per engine (default: 5)\n"
+            "  --seed S         generator seed (default: 1)\n"
+            "  --format F       csv or json (default: csv)\n"
+            "  --out FILE       write results to FILE (default: stdout)\n",
+            prog);
+}
+
+// Splits "a,b,c" and calls add(item) for each; returns 0 on the first rejected item
+static int parse_list(const char *list, int (*add)(BenchOptions*, const char*), BenchOptions *opt) {
+    char item[64];
+    const char *p = list;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        if (!end) end = p + strlen(p);
+        size_t len = (size_t)(end - p);
+        if (len == 0 || len >= sizeof(item)) return 0;
+        memcpy(item, p, len);
+        item[len] = '\0';
+        if (!add(opt, item)) {
+            fprintf(stderr, "Error: unknown value '%s'\n", item);
+            return 0;
+        }
+        p = *end ? end + 1 : end;
+    }
+    return 1;
+}
+
+static int add_shape(BenchOptions *opt, const char *name) {
+    KbShape s;
+    if (!kbgen_shape_from_name(name, &s)) return 0;
+    opt->shapes[s] = 1;
+    return 1;
+}
+
+static int add_size(BenchOptions *opt, const char *text) {
+    char *end = NULL;
+    unsigned long long n = strtoull(text, &end, 10);
+    if (!end || *end || n == 0 || opt->nsizes == MAX_SIZES) return 0;
+    opt->sizes[opt->nsizes++] = (size_t)n;
+    return 1;
+}
+
+static int add_engine(BenchOptions *opt, const char *name) {
+    for (int e = 0; e < BENCH_ENGINE_COUNT; ++e) {
+        if (strcmp(name, ENGINE_NAMES[e]) == 0) {
+            opt->engines[e] = 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Lance un moteur sur une base de faits.
+ * @param engine Moteur mesuré.
+ * @param bc Base de connaissances (moteur naïf sur listes).
+ * @param cbc Base compilée (autres moteurs).
+ * @param bf Base de faits (modifiée en place).
+ * @param goal But du chaînage arrière.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+static int run_engine(BenchEngine engine, const BC *bc, const CompiledBC *cbc, BaseFaits *bf, Proposition goal) {
+    switch (engine) {
+        case BENCH_NAIVE: inference_forward_chain(bc, bf); return 1;
+        case BENCH_COMPILED: inference_forward_chain_compiled(cbc, bf); return 1;
+        case BENCH_AGENDA: return inference_run_compiled(cbc, bf, ENGINE_AGENDA);
+        case BENCH_STRATIFIED: return inference_run_compiled(cbc, bf, ENGINE_STRATIFIED);
+        case BENCH_BACKWARD: {
+            BackwardIndex idx = backward_index_create(cbc);
+            backward_prove(&idx, bf, goal);
+            backward_index_free(&idx);
+            return 1;
+        }
+        default: return 0;
+    }
+}
+
+// Same facts (the insertion order may differ between engines)
+static int same_closure(const BaseFaits *a, const BaseFaits *b) {
+    if (facts_size(a) != facts_size(b)) return 0;
+    size_t it = 0;
+    Proposition p;
+    while (facts_next(a, &it, &p)) {
+        if (!facts_contains(b, &p)) return 0;
+    }
+    return 1;
+}
+
+static void write_header(FILE *out, const BenchOptions *opt) {
+    if (opt->json) {
+        fprintf(out, "{\n  \"alloc_counting\": %s,\n  \"repeat\": %d,\n  \"seed\": %llu,\n  \"results\": [",
+                alloc_count_enabled() ? "true" : "false", opt->repeat, (unsigned long long)opt->seed);
+    } else {
+        fprintf(out, "shape,size,rules,symbols,premises,engine,status,load_ms,compile_ms,load_allocs,"
+                     "mean_us,min_us,p50_us,p95_us,runs_per_s,rules_per_s,facts_in,facts_out,"
+                     "allocs_per_run,bytes_per_run,peak_bytes,maxrss_kb\n");
+    }
+}
+
+static void write_row(FILE *out, const BenchOptions *opt, const BenchRow *r, int first) {
+    if (opt->json) {
+        fprintf(out, "%s\n    {\"shape\": \"%s\", \"size\": %zu, \"rules\": %zu, \"symbols\": %zu, \"premises\": %zu, "
+                     "\"engine\": \"%s\", \"status\": \"%s\", \"load_ms\": %.3f, \"compile_ms\": %.3f, \"load_allocs\": %zu, "
+                     "\"mean_us\": %.2f, \"min_us\": %.2f, \"p50_us\": %.2f, \"p95_us\": %.2f, "
+                     "\"runs_per_s\": %.2f, \"rules_per_s\": %.0f, \"facts_in\": %zu, \"facts_out\": %zu, "
+                     "\"allocs_per_run\": %.1f, \"bytes_per_run\": %.0f, \"peak_bytes\": %zu, \"maxrss_kb\": %ld}",
+                first ? "" : ",", r->shape, r->size, r->rules, r->symbols, r->premises, r->engine, r->status,
+                r->load_ms, r->compile_ms, r->load_allocs, r->mean_us, r->min_us, r->p50_us, r->p95_us,
+                r->runs_per_s, r->rules_per_s, r->facts_in, r->facts_out, r->allocs_per_run, r->bytes_per_run,
+                r->peak_bytes, r->maxrss_kb);
+    } else {
+        fprintf(out, "%s,%zu,%zu,%zu,%zu,%s,%s,%.3f,%.3f,%zu,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f,%zu,%zu,%.1f,%.0f,%zu,%ld\n",
+                r->shape, r->size, r->rules, r->symbols, r->premises, r->engine, r->status, r->load_ms,
+                r->compile_ms, r->load_allocs, r->mean_us, r->min_us, r->p50_us, r->p95_us, r->runs_per_s,
+                r->rules_per_s, r->facts_in, r->facts_out, r->allocs_per_run, r->bytes_per_run, r->peak_bytes,
+                r->maxrss_kb);
+    }
+    fflush(out);
+}
+
+static void write_footer(FILE *out, const BenchOptions *opt) {
+    if (opt->json) fprintf(out, "\n  ]\n}\n");
+}
+
+/**
+ * Mesure une base générée avec chacun des moteurs choisis.
+ * @param out Flux des résultats.
+ * @param opt Options.
+ * @param shape Forme de la base.
+ * @param size Nombre de règles visé.
+ * @param first Entrée/sortie: 1 tant qu'aucune ligne n'a été écrite.
+ * @return Nombre de moteurs dont la clôture diffère de celle du moteur naïf
+ *         sur une base sans négation (erreur de chargement: 1).
+ */
+static int bench_kb(FILE *out, const BenchOptions *opt, KbShape shape, size_t size, int *first) {
+    GeneratedKB kb = kbgen_generate(shape, size, opt->seed);
+    BenchRow base;
+    memset(&base, 0, sizeof(base));
+    base.shape = kbgen_shape_name(shape);
+    base.size = size;
+
+    // Load and compile from scratch each time: empty symbol table, new base
+    BC bc = bc_create();
+    CompiledBC cbc;
+    memset(&cbc, 0, sizeof(cbc));
+    double load_total = 0, compile_total = 0;
+    for (int r = 0; r < opt->repeat; ++r) {
+        compiled_free(&cbc);
+        bc_free(&bc);
+        symbols_reset();
+        bc = bc_create();
+        LoadError err;
+        alloc_count_reset();
+        double t0 = now_seconds();
+        int ok = loader_load_text(&bc, kb.rules, kb.rules_len, &base.rules, &err);
+        double t1 = now_seconds();
+        AllocStats as;
+        alloc_count_get(&as);
+        if (!ok) {
+            fprintf(stderr, "Error: generated %s base, line %zu: %s\n", base.shape, err.line, err.message);
+            kbgen_free(&kb);
+            bc_free(&bc);
+            return 1;
+        }
+        cbc = bc_compile(&bc);
+        double t2 = now_seconds();
+        load_total += t1 - t0;
+        compile_total += t2 - t1;
+        base.load_allocs = as.allocs;
+    }
+    base.load_ms = load_total * 1e3 / opt->repeat;
+    base.compile_ms = compile_total * 1e3 / opt->repeat;
+    base.symbols = (size_t)symbol_count();
+    base.premises = cbc.npremises;
+
+    BaseFaits initial = facts_create();
+    facts_reserve(&initial, (size_t)symbol_count());
+    for (char *p = kb.facts; *p;) {
+        char *end = strchr(p, '\n');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len) {
+            Proposition prop = { symbol_intern_n(p, len), 0 };
+            facts_add(&initial, prop);
+        }
+        p += len + (end ? 1 : 0);
+    }
+    base.facts_in = facts_size(&initial);
+
+    // Reference closure for the cross-check. Every generated base is
+    // stratifiable and written in dependency order, where all engines agree;
+    // only a negative cycle makes the result depend on the firing order.
+    BaseFaits reference = facts_copy(&initial);
+    inference_forward_chain(&bc, &reference);
+    Strata strata;
+    int order_dependent = !inference_stratify(&cbc, &strata);
+    strata_free(&strata);
+    // Backward goal: the last fact the naive engine derived, the end of the
+    // longest chain for the chain shape (deep search, no recursion limit)
+    Proposition goal = { SYMBOL_NONE, 0 };
+    size_t it = 0;
+    Proposition p;
+    while (facts_next(&reference, &it, &p)) goal = p;
+
+    int mismatches = 0;
+    double *samples = (double*)malloc((size_t)opt->repeat * sizeof(double));
+    for (int e = 0; e < BENCH_ENGINE_COUNT; ++e) {
+        if (!opt->engines[e]) continue;
+        BenchRow row = base;
+        row.engine = ENGINE_NAMES[e];
+        row.status = "ok";
+
+        // Warm-up run, also checked against the reference
+        BaseFaits bf = facts_copy(&initial);
+        if (!run_engine((BenchEngine)e, &bc, &cbc, &bf, goal)) {
+            row.status = "rejected";
+        } else if (e == BENCH_BACKWARD) {
+            // Only the goal and its sub-goals are derived
+            if (goal.id != SYMBOL_NONE && !facts_contains(&bf, &goal)) {
+                row.status = order_dependent ? "differs" : "mismatch";
+                if (!order_dependent) mismatches++;
+            }
+        } else if (!same_closure(&reference, &bf)) {
+            row.status = order_dependent ? "differs" : "mismatch";
+            if (!order_dependent) mismatches++;
+        }
+        row.facts_out = facts_size(&bf);
+        facts_free(&bf);
+
+        if (strcmp(row.status, "rejected") != 0) {
+            size_t allocs = 0, bytes = 0;
+            for (int r = 0; r < opt->repeat; ++r) {
+                bf = facts_copy(&initial);
+                alloc_count_reset();
+                double t0 = now_seconds();
+                run_engine((BenchEngine)e, &bc, &cbc, &bf, goal);
+                double t1 = now_seconds();
+                AllocStats as;
+                alloc_count_get(&as);
+                facts_free(&bf);
+                samples[r] = (t1 - t0) * 1e6;
+                allocs += as.allocs;
+                bytes += as.bytes;
+                if (as.peak > row.peak_bytes) row.peak_bytes = as.peak;
+            }
+            double sum = 0;
+            for (int r = 0; r < opt->repeat; ++r) sum += samples[r];
+            qsort(samples, (size_t)opt->repeat, sizeof(double), cmp_double);
+            row.mean_us = sum / opt->repeat;
+            row.min_us = samples[0];
+            row.p50_us = samples[(opt->repeat - 1) / 2];
+            row.p95_us = samples[(opt->repeat - 1) * 95 / 100];
+            row.runs_per_s = row.mean_us > 0 ? 1e6 / row.mean_us : 0;
+            row.rules_per_s = row.runs_per_s * (double)row.rules;
+            row.allocs_per_run = (double)allocs / opt->repeat;
+            row.bytes_per_run = (double)bytes / opt->repeat;
+        }
+        row.maxrss_kb = maxrss_kb();
+        write_row(out, opt, &row, *first);
+        *first = 0;
+    }
+    free(samples);
+    facts_free(&reference);
+    facts_free(&initial);
+    compiled_free(&cbc);
+    bc_free(&bc);
+    symbols_reset();
+    kbgen_free(&kb);
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.repeat = 5;
+    opt.seed = 1;
+    int any_shape = 0, any_engine = 0;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        int ok = 1;
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else if (!val) {
+            ok = 0;
+        } else if (strcmp(arg, "--shapes") == 0) {
+            ok = parse_list(val, add_shape, &opt);
+            any_shape = 1;
+        } else if (strcmp(arg, "--sizes") == 0) {
+            ok = parse_list(val, add_size, &opt);
+        } else if (strcmp(arg, "--engines") == 0) {
+            ok = parse_list(val, add_engine, &opt);
+            any_engine = 1;
+        } else if (strcmp(arg, "--repeat") == 0) {
+            opt.repeat = atoi(val);
+            ok = opt.repeat > 0;
+        } else if (strcmp(arg, "--seed") == 0) {
+            opt.seed = strtoull(val, NULL, 10);
+        } else if (strcmp(arg, "--format") == 0) {
+            ok = strcmp(val, "csv") == 0 || strcmp(val, "json") == 0;
+            opt.json = strcmp(val, "json") == 0;
+        } else if (strcmp(arg, "--out") == 0) {
+            opt.out_path = val;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (!any_shape) {
+        for (int s = 0; s < KB_SHAPE_COUNT; ++s) opt.shapes[s] = 1;
+    }
+    if (!any_engine) {
+        for (int e = 0; e < BENCH_ENGINE_COUNT; ++e) opt.engines[e] = 1;
+    }
+    if (opt.nsizes == 0) {
+        opt.sizes[opt.nsizes++] = 1000;
+        opt.sizes[opt.nsizes++] = 10000;
+    }
+
+    FILE *out = stdout;
+    if (opt.out_path) {
+        out = fopen(opt.out_path, "w");
+        if (!out) {
+            fprintf(stderr, "Error: cannot open %s\n", opt.out_path);
+            return 1;
+        }
+    }
+    if (!alloc_count_enabled()) fprintf(stderr, "Note: allocation counting unavailable in this build\n");
+
+    int mismatches = 0, first = 1;
+    write_header(out, &opt);
+    for (int s = 0; s < KB_SHAPE_COUNT; ++s) {
+        if (!opt.shapes[s]) continue;
+        for (size_t k = 0; k < opt.nsizes; ++k) {
+            mismatches += bench_kb(out, &opt, (KbShape)s, opt.sizes[k], &first);
+        }
+    }
+    write_footer(out, &opt);
+    if (out != stdout) fclose(out);
+    if (mismatches) fprintf(stderr, "Error: %d engine result(s) differ from the naive engine\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kbgen.h"
+
+static const char *const SHAPE_NAMES[KB_SHAPE_COUNT] = { "chain", "fanin", "dag", "neg", "example", "negorder" };
+
+// Number of derived layers of KB_DAG / KB_NEG
+#define DAG_LAYERS 8
+
+typedef struct TextBuf {
+    char *data;
+    size_t len;
+    size_t cap;
+} TextBuf;
+
+static void buf_printf(TextBuf *b, const char *fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(b->data ? b->data + b->len : NULL, b->data ? b->cap - b->len : 0, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if (b->data && b->len + (size_t)n < b->cap) {
+            b->len += (size_t)n;
+            return;
+        }
+        size_t cap = b->cap ? b->cap : 4096;
+        while (cap <= b->len + (size_t)n) cap *= 2;
+        b->data = (char*)realloc(b->data, cap);
+        b->cap = cap;
+    }
+}
+
+// xorshift64*: fast and reproducible across platforms
+static uint64_t rng_next(uint64_t *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 2685821657736338717ull;
+}
+
+static size_t rng_below(uint64_t *s, size_t n) {
+    return n ? (size_t)(rng_next(s) % n) : 0;
+}
+
+// Percent chance
+static int rng_chance(uint64_t *s, unsigned pct) {
+    return rng_below(s, 100) < pct;
+}
+
+static void gen_chain(TextBuf *r, TextBuf *f, size_t *nfacts, size_t n) {
+    // Reverse order: each naive pass only moves one link further
+    for (size_t i = n; i-- > 0;) buf_printf(r, "C%zu => C%zu\n", i, i + 1);
+    buf_printf(f, "C0\n");
+    *nfacts = 1;
+}
+
+static void gen_fanin(TextBuf *r, TextBuf *f, size_t *nfacts, size_t n, uint64_t *rng) {
+    size_t ninputs = 64 + n / 16;
+    for (size_t i = 0; i < n; ++i) {
+        size_t width = 8 + rng_below(rng, 25);
+        for (size_t k = 0; k < width; ++k) {
+            // A quarter of the premises reuse earlier conclusions
+            if (i > 0 && rng_chance(rng, 25)) buf_printf(r, "%sF%zu", k ? " & " : "", rng_below(rng, i));
+            else buf_printf(r, "%sI%zu", k ? " & " : "", rng_below(rng, ninputs));
+        }
+        buf_printf(r, " => F%zu\n", i);
+    }
+    *nfacts = 0;
+    for (size_t i = 0; i < ninputs; ++i) {
+        if (rng_chance(rng, 95)) {
+            buf_printf(f, "I%zu\n", i);
+            (*nfacts)++;
+        }
+    }
+}
+
+static void gen_dag(TextBuf *r, TextBuf *f, size_t *nfacts, size_t n, unsigned neg_pct, uint64_t *rng) {
+    // Layer 0 holds the inputs; about two rules per derived node
+    size_t width = n / (2 * DAG_LAYERS);
+    if (width < 4) width = 4;
+    size_t ninputs = width;
+    for (size_t i = 0; i < n; ++i) {
+        size_t layer = 1 + i * DAG_LAYERS / (n ? n : 1);
+        size_t npremises = 1 + rng_below(rng, 3);
+        for (size_t k = 0; k < npremises; ++k) {
+            // Mostly the previous layer, sometimes any lower one
+            size_t from = rng_chance(rng, 60) ? layer - 1 : rng_below(rng, layer);
+            size_t node = rng_below(rng, from == 0 ? ninputs : width);
+            buf_printf(r, "%s%sL%zu_%zu", k ? " & " : "", rng_chance(rng, neg_pct) ? "!" : "", from, node);
+        }
+        buf_printf(r, " => L%zu_%zu\n", layer, rng_below(rng, width));
+    }
+    *nfacts = 0;
+    for (size_t i = 0; i < ninputs; ++i) {
+        if (rng_chance(rng, 60)) {
+            buf_printf(f, "L0_%zu\n", i);
+            (*nfacts)++;
+        }
+    }
+}
+
+static void gen_example(TextBuf *r, TextBuf *f, size_t *nfacts, size_t n, uint64_t *rng) {
+    static const char *const INPUTS[5] = { "A", "B", "C", "D", "E" };
+    size_t copies = (n + 4) / 5;
+    *nfacts = 0;
+    for (size_t c = 0; c < copies; ++c) {
+        buf_printf(r, "A_%zu & B_%zu & C_%zu => R1_%zu\n", c, c, c, c);
+        buf_printf(r, "!C_%zu & D_%zu & E_%zu => R2_%zu\n", c, c, c, c);
+        buf_printf(r, "A_%zu & C_%zu => R3_%zu\n", c, c, c);
+        buf_printf(r, "R1_%zu & D_%zu & E_%zu => R4_%zu\n", c, c, c, c);
+        buf_printf(r, "!R3_%zu & B_%zu => R5_%zu\n", c, c, c);
+        // Each copy sees different inputs, so every rule fires somewhere
+        for (int k = 0; k < 5; ++k) {
+            if (rng_chance(rng, 70)) {
+                buf_printf(f, "%s_%zu\n", INPUTS[k], c);
+                (*nfacts)++;
+            }
+        }
+    }
+}
+
+// Regression base for the agenda: '!E => D' is ready from the start, but E
+// comes from a rule that itself waits on a negated premise
+static void gen_neg_order(TextBuf *r, TextBuf *f, size_t *nfacts, size_t n, uint64_t *rng) {
+    size_t copies = (n + 1) / 2;
+    *nfacts = 0;
+    for (size_t c = 0; c < copies; ++c) {
+        buf_printf(r, "A_%zu & !F_%zu => E_%zu\n", c, c, c);
+        buf_printf(r, "!E_%zu => D_%zu\n", c, c);
+        if (rng_chance(rng, 70)) {
+            buf_printf(f, "A_%zu\n", c);
+            (*nfacts)++;
+        }
+    }
+}
+
+/**
+ * Génère une base synthétique.
+ * @param shape Forme de la base.
+ * @param nrules Nombre de règles visé.
+ * @param seed Graine du générateur pseudo-aléatoire.
+ * @return Base générée (à libérer avec kbgen_free).
+ */
+GeneratedKB kbgen_generate(KbShape shape, size_t nrules, uint64_t seed) {
+    GeneratedKB kb;
+    memset(&kb, 0, sizeof(kb));
+    TextBuf r = { NULL, 0, 0 }, f = { NULL, 0, 0 };
+    uint64_t rng = seed ? seed : 0x9E3779B97F4A7C15ull;
+    switch (shape) {
+        case KB_CHAIN: gen_chain(&r, &f, &kb.nfacts, nrules); kb.nrules = nrules; break;
+        case KB_FANIN: gen_fanin(&r, &f, &kb.nfacts, nrules, &rng); kb.nrules = nrules; break;
+        case KB_DAG: gen_dag(&r, &f, &kb.nfacts, nrules, 0, &rng); kb.nrules = nrules; break;
+        case KB_NEG: gen_dag(&r, &f, &kb.nfacts, nrules, 30, &rng); kb.nrules = nrules; break;
+        case KB_EXAMPLE: gen_example(&r, &f, &kb.nfacts, nrules, &rng); kb.nrules = 5 * ((nrules + 4) / 5); break;
+        case KB_NEG_ORDER: gen_neg_order(&r, &f, &kb.nfacts, nrules, &rng); kb.nrules = 2 * ((nrules + 1) / 2); break;
+        default: break;
+    }
+    // Never hand out NULL text
+    if (!r.data) r.data = (char*)calloc(1, 1);
+    if (!f.data) f.data = (char*)calloc(1, 1);
+    kb.rules = r.data;
+    kb.rules_len = r.len;
+    kb.facts = f.data;
+    return kb;
+}
+
+/**
+ * Libère une base générée.
+ * @param kb Base générée.
+ * @return Aucun.
+ */
+void kbgen_free(GeneratedKB *kb) {
+    if (!kb) return;
+    free(kb->rules);
+    free(kb->facts);
+    memset(kb, 0, sizeof(*kb));
+}
+
+/**
+ * Donne le nom court d'une forme.
+ * @param shape Forme.
+ * @return Nom court, "?" si inconnue.
+ */
+const char *kbgen_shape_name(KbShape shape) {
+    if ((int)shape < 0 || shape >= KB_SHAPE_COUNT) return "?";
+    return SHAPE_NAMES[shape];
+}
+
+/**
+ * Retrouve une forme par son nom court.
+ * @param name Nom.
+ * @param out Sortie: forme.
+ * @return 1 si trouvée, 0 sinon.
+ */
+int kbgen_shape_from_name(const char *name, KbShape *out) {
+    if (!name) return 0;
+    for (int s = 0; s < KB_SHAPE_COUNT; ++s) {
+        if (strcmp(name, SHAPE_NAMES[s]) == 0) {
+            if (out) *out = (KbShape)s;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Formes de bases de connaissances synthétiques.
+typedef enum KbShape {
+    KB_CHAIN = 0,   // longue chaîne d'implications C0 => C1 => ... (règles en ordre inverse)
+    KB_FANIN,       // règles larges (8 à 32 prémisses) sur un réservoir d'entrées
+    KB_DAG,         // graphe en couches aléatoire, plusieurs règles par conclusion
+    KB_NEG,         // comme KB_DAG, avec ~30% de prémisses négées
+    KB_EXAMPLE,     // copies de la base d'exemple de main.c (R1 à R5)
+    KB_NEG_ORDER,   // copies de "A & !F => E", "!E => D": ¬E ne se teste qu'après E
+    KB_SHAPE_COUNT
+} KbShape;
+
+// Base générée, au format des fichiers de règles (voir loader.h).
+typedef struct GeneratedKB {
+    char *rules;        // texte des règles
+    size_t rules_len;
+    size_t nrules;
+    char *facts;        // faits initiaux: noms séparés par '\n'
+    size_t nfacts;
+} GeneratedKB;
+
+/**
+ * Génère une base synthétique (reproductible pour une graine donnée).
+ * @param shape Forme de la base.
+ * @param nrules Nombre de règles visé (KB_EXAMPLE arrondit au multiple de 5,
+ *               KB_NEG_ORDER au multiple de 2).
+ * @param seed Graine du générateur pseudo-aléatoire.
+ * @return Base générée (à libérer avec kbgen_free).
+ */
+GeneratedKB kbgen_generate(KbShape shape, size_t nrules, uint64_t seed);
+
+/**
+ * Libère une base générée.
+ * @param kb Base générée.
+ * @return Aucun.
+ */
+void kbgen_free(GeneratedKB *kb);
+
+/**
+ * Donne le nom court d'une forme.
+ * @param shape Forme.
+ * @return Nom ("chain", "fanin", "dag", "neg", "example", "negorder").
+ */
+const char *kbgen_shape_name(KbShape shape);
+
+/**
+ * Retrouve une forme par son nom court.
+ * @param name Nom.
+ * @param out Sortie: forme.
+ * @return 1 si trouvée, 0 sinon.
+ */
+int kbgen_shape_from_name(const char *name, KbShape *out);
@@ -0,0 +1,309 @@
+// Load generator for --serve-unix: concurrent clients, latency percentiles
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "bc.h"
+#include "loader.h"
+#include "server.h"
+#include "symbol.h"
+
+typedef struct LoadOptions {
+    const char *socket_path;
+    int clients;
+    long requests;           // per client
+    const char *goal;        // goal queries instead of closures
+    uint64_t seed;
+    char **inputs;           // names drawn into each request
+    size_t ninputs;
+} LoadOptions;
+
+// One client thread: its own connection and latency samples
+typedef struct LoadClient {
+    const LoadOptions *opt;
+    pthread_barrier_t *start;
+    uint64_t rng;
+    double *latency_us;
+    long done;
+    int failed;
+} LoadClient;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t next_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+/**
+ * Affiche l'aide.
+ * @param prog Nom du programme.
+ * @return Aucun.
+ */
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s --socket PATH [options]\n"
+            "  --socket PATH    server socket (sys_expert --serve-unix PATH)\n"
+            "  --clients N      concurrent connections (default: 8)\n"
+            "  --requests N     requests per connection (default: 10000)\n"
+            "  --inputs LIST    names drawn into each request (default: A,B,C,D,E)\n"
+            "  --rules FILE     draw from the inputs of a rules file instead\n"
+            "  --goal NAME      send goal queries \"?NAME facts\" instead of closures\n"
+            "  --seed S         request generator seed (default: 1)\n",
+            prog);
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, data, len);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return 0;
+        data += w;
+        len -= (size_t)w;
+    }
+    return 1;
+}
+
+static int read_all(int fd, char *data, size_t len) {
+    while (len > 0) {
+        ssize_t r = read(fd, data, len);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return 0;
+        data += r;
+        len -= (size_t)r;
+    }
+    return 1;
+}
+
+static int connect_to(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Header and a random subset of the inputs (each drawn with probability 1/2)
+static size_t build_request(LoadClient *c, char *buf, size_t cap) {
+    const LoadOptions *opt = c->opt;
+    size_t len = SERVER_HEADER;
+    if (opt->goal) len += (size_t)snprintf(buf + len, cap - len, "?%s ", opt->goal);
+    int first = 1;
+    uint64_t bits = 0;
+    for (size_t k = 0; k < opt->ninputs; ++k) {
+        if (k % 64 == 0) bits = next_random(&c->rng);
+        if (!((bits >> (k % 64)) & 1)) continue;
+        size_t n = strlen(opt->inputs[k]);
+        if (len + n + 1 >= cap) break;
+        if (!first) buf[len++] = ',';
+        memcpy(buf + len, opt->inputs[k], n);
+        len += n;
+        first = 0;
+    }
+    server_frame_header((unsigned char*)buf, (uint32_t)(len - SERVER_HEADER));
+    return len;
+}
+
+static void *client_main(void *arg) {
+    LoadClient *c = (LoadClient*)arg;
+    const LoadOptions *opt = c->opt;
+    int fd = connect_to(opt->socket_path);
+    // Every client waits for the others, connected or not, so main can time the run
+    pthread_barrier_wait(c->start);
+    if (fd < 0) {
+        c->failed = 1;
+        return NULL;
+    }
+    size_t cap = SERVER_HEADER + SERVER_MAX_FRAME;
+    char *req = (char*)malloc(cap);
+    char *resp = (char*)malloc(cap);
+    for (long i = 0; i < opt->requests; ++i) {
+        size_t len = build_request(c, req, cap);
+        double t0 = now_seconds();
+        unsigned char header[SERVER_HEADER];
+        if (!write_all(fd, req, len) || !read_all(fd, (char*)header, SERVER_HEADER)) {
+            c->failed = 1;
+            break;
+        }
+        uint32_t rlen = server_frame_length(header);
+        if (rlen > SERVER_MAX_FRAME || !read_all(fd, resp, rlen)) {
+            c->failed = 1;
+            break;
+        }
+        c->latency_us[c->done++] = (now_seconds() - t0) * 1e6;
+    }
+    free(resp);
+    free(req);
+    close(fd);
+    return NULL;
+}
+
+// Splits "a,b,c" into opt->inputs
+static void add_input_list(LoadOptions *opt, const char *list) {
+    const char *p = list;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        if (!end) end = p + strlen(p);
+        if (end > p) {
+            opt->inputs = (char**)realloc(opt->inputs, (opt->ninputs + 1) * sizeof(char*));
+            opt->inputs[opt->ninputs] = (char*)malloc((size_t)(end - p) + 1);
+            memcpy(opt->inputs[opt->ninputs], p, (size_t)(end - p));
+            opt->inputs[opt->ninputs++][end - p] = '\0';
+        }
+        p = *end ? end + 1 : end;
+    }
+}
+
+static int add_rules_inputs(LoadOptions *opt, const char *path) {
+    BC bc = bc_create();
+    LoadError err;
+    if (!loader_load_file(&bc, path, NULL, &err)) {
+        if (err.line) fprintf(stderr, "%s:%zu:%zu: error: %s\n", path, err.line, err.column, err.message);
+        else fprintf(stderr, "Error: %s: %s\n", path, err.message);
+        bc_free(&bc);
+        return 0;
+    }
+    int *ids = NULL;
+    size_t n = bc_input_symbols(&bc, &ids);
+    opt->inputs = (char**)realloc(opt->inputs, (opt->ninputs + n + 1) * sizeof(char*));
+    for (size_t k = 0; k < n; ++k) opt->inputs[opt->ninputs++] = strdup(symbol_name(ids[k]));
+    free(ids);
+    bc_free(&bc);
+    return 1;
+}
+
+static double percentile(const double *sorted, long n, double q) {
+    if (n == 0) return 0.0;
+    long k = (long)(q * (double)(n - 1) + 0.5);
+    return sorted[k];
+}
+
+int main(int argc, char **argv) {
+    LoadOptions opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.clients = 8;
+    opt.requests = 10000;
+    opt.seed = 1;
+    const char *rules_path = NULL, *input_list = "A,B,C,D,E";
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        int ok = 1;
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else if (!val) {
+            ok = 0;
+        } else if (strcmp(arg, "--socket") == 0) {
+            opt.socket_path = val;
+        } else if (strcmp(arg, "--clients") == 0) {
+            opt.clients = atoi(val);
+            ok = opt.clients > 0;
+        } else if (strcmp(arg, "--requests") == 0) {
+            opt.requests = atol(val);
+            ok = opt.requests > 0;
+        } else if (strcmp(arg, "--inputs") == 0) {
+            input_list = val;
+        } else if (strcmp(arg, "--rules") == 0) {
+            rules_path = val;
+        } else if (strcmp(arg, "--goal") == 0) {
+            opt.goal = val;
+        } else if (strcmp(arg, "--seed") == 0) {
+            opt.seed = strtoull(val, NULL, 10);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (!opt.socket_path) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (rules_path) {
+        if (!add_rules_inputs(&opt, rules_path)) return 1;
+    } else {
+        add_input_list(&opt, input_list);
+    }
+
+    LoadClient *clients = (LoadClient*)calloc((size_t)opt.clients, sizeof(LoadClient));
+    pthread_t *threads = (pthread_t*)calloc((size_t)opt.clients, sizeof(pthread_t));
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)opt.clients + 1);
+    int started = 0;
+    for (int t = 0; t < opt.clients; ++t) {
+        LoadClient *c = &clients[t];
+        c->opt = &opt;
+        c->start = &start;
+        c->rng = (opt.seed + 1) * 0x9e3779b97f4a7c15ULL + (uint64_t)t * 0xbf58476d1ce4e5b9ULL;
+        if (c->rng == 0) c->rng = 1;
+        c->latency_us = (double*)malloc((size_t)opt.requests * sizeof(double));
+        if (pthread_create(&threads[t], NULL, client_main, c) != 0) {
+            fprintf(stderr, "Error: cannot start client threads\n");
+            return 1;
+        }
+        started++;
+    }
+    pthread_barrier_wait(&start);
+    double t0 = now_seconds();
+    for (int t = 0; t < started; ++t) pthread_join(threads[t], NULL);
+    double seconds = now_seconds() - t0;
+
+    // All samples together: the percentiles describe the whole run
+    long total = 0;
+    int failed = 0;
+    for (int t = 0; t < opt.clients; ++t) {
+        total += clients[t].done;
+        failed += clients[t].failed;
+    }
+    double *all = (double*)malloc((size_t)(total ? total : 1) * sizeof(double));
+    long n = 0;
+    for (int t = 0; t < opt.clients; ++t) {
+        memcpy(all + n, clients[t].latency_us, (size_t)clients[t].done * sizeof(double));
+        n += clients[t].done;
+        free(clients[t].latency_us);
+    }
+    qsort(all, (size_t)n, sizeof(double), cmp_double);
+    double mean = 0.0;
+    for (long k = 0; k < n; ++k) mean += all[k];
+    if (n) mean /= (double)n;
+    printf("clients,requests,seconds,requests_per_s,mean_us,p50_us,p90_us,p99_us,p999_us,max_us,failed_clients\n");
+    printf("%d,%ld,%.3f,%.0f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%d\n", opt.clients, n, seconds,
+           seconds > 0 ? (double)n / seconds : 0.0, mean, percentile(all, n, 0.50), percentile(all, n, 0.90),
+           percentile(all, n, 0.99), percentile(all, n, 0.999), n ? all[n - 1] : 0.0, failed);
+
+    free(all);
+    pthread_barrier_destroy(&start);
+    free(threads);
+    free(clients);
+    for (size_t k = 0; k < opt.ninputs; ++k) free(opt.inputs[k]);
+    free(opt.inputs);
+    if (failed) fprintf(stderr, "Error: %d client(s) could not connect or lost their connection\n", failed);
+    return failed ? 1 : 0;
+}
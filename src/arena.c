@@ -0,0 +1,90 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_DEFAULT_CHUNK (64 * 1024)
+#define ARENA_ALIGN 16
+
+// Chunk header is padded so that the first object is aligned too
+#define ARENA_HEADER (((sizeof(ArenaChunk) + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN)
+
+/**
+ * Crée une arène vide.
+ * @param chunk_size Taille des blocs en octets (0: valeur par défaut).
+ * @return Arène initialisée.
+ */
+Arena arena_create(size_t chunk_size) {
+    Arena a;
+    a.head = NULL;
+    a.chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK;
+    a.chunks = 0;
+    a.bytes = 0;
+    return a;
+}
+
+// Bump-allocates 'size' bytes aligned on 'align' (a power of two)
+static void *arena_alloc_aligned(Arena *a, size_t size, size_t align) {
+    ArenaChunk *c = a->head;
+    size_t off = c ? (c->used + align - 1) & ~(align - 1) : 0;
+    if (!c || off > c->cap || c->cap - off < size) {
+        size_t chunk = a->chunk_size ? a->chunk_size : ARENA_DEFAULT_CHUNK;
+        size_t cap = size > chunk ? size : chunk;
+        c = (ArenaChunk*)malloc(ARENA_HEADER + cap);
+        if (!c) return NULL;
+        c->used = 0;
+        c->cap = cap;
+        c->next = a->head;
+        a->head = c;
+        a->chunks++;
+        off = 0;
+    }
+    void *p = (char*)c + ARENA_HEADER + off;
+    c->used = off + size;
+    a->bytes += size;
+    return p;
+}
+
+/**
+ * Alloue un objet dans l'arène.
+ * @param a Arène.
+ * @param size Taille en octets.
+ * @return Pointeur vers la zone allouée.
+ */
+void *arena_alloc(Arena *a, size_t size) {
+    if (!a) return NULL;
+    return arena_alloc_aligned(a, size ? size : 1, ARENA_ALIGN);
+}
+
+/**
+ * Copie une chaîne dans l'arène, terminée par '\0'.
+ * @param a Arène.
+ * @param s Début de la chaîne.
+ * @param len Longueur en octets.
+ * @return Copie terminée par '\0'.
+ */
+char *arena_strndup(Arena *a, const char *s, size_t len) {
+    if (!a) return NULL;
+    char *dst = (char*)arena_alloc_aligned(a, len + 1, 1); // names need no alignment
+    if (!dst) return NULL;
+    memcpy(dst, s, len);
+    dst[len] = '\0';
+    return dst;
+}
+
+/**
+ * Libère tous les blocs de l'arène en une fois.
+ * @param a Arène.
+ * @return Aucun.
+ */
+void arena_free(Arena *a) {
+    if (!a) return;
+    ArenaChunk *c = a->head;
+    while (c) {
+        ArenaChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    a->head = NULL;
+    a->chunks = 0;
+    a->bytes = 0;
+}
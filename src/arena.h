@@ -0,0 +1,50 @@
+#pragma once
+#include <stddef.h>
+
+// Bloc contigu d'une arène.
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t used;
+    size_t cap;
+} ArenaChunk;
+
+// Allocateur par incrément de pointeur: les objets sont placés à la suite
+// dans de grands blocs et libérés tous ensemble en O(nombre de blocs).
+typedef struct Arena {
+    ArenaChunk *head;   // bloc courant (les précédents suivent via next)
+    size_t chunk_size;  // taille par défaut d'un nouveau bloc
+    size_t chunks;      // nombre de blocs alloués
+    size_t bytes;       // octets servis
+} Arena;
+
+/**
+ * Crée une arène vide (aucun bloc alloué avant la première allocation).
+ * @param chunk_size Taille des blocs en octets (0: valeur par défaut).
+ * @return Arène initialisée.
+ */
+Arena arena_create(size_t chunk_size);
+
+/**
+ * Alloue un objet dans l'arène (aligné pour tout type standard).
+ * La mémoire n'est pas initialisée et n'est rendue que par arena_free.
+ * @param a Arène.
+ * @param size Taille en octets.
+ * @return Pointeur vers la zone allouée.
+ */
+void *arena_alloc(Arena *a, size_t size);
+
+/**
+ * Copie une chaîne (pointeur + longueur) dans l'arène, terminée par '\0'.
+ * @param a Arène.
+ * @param s Début de la chaîne.
+ * @param len Longueur en octets.
+ * @return Copie terminée par '\0'.
+ */
+char *arena_strndup(Arena *a, const char *s, size_t len);
+
+/**
+ * Libère tous les blocs de l'arène en une fois.
+ * @param a Arène.
+ * @return Aucun.
+ */
+void arena_free(Arena *a);
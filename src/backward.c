@@ -0,0 +1,216 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "backward.h"
+
+// Sub-goal states stored in idx->state. In-progress goals record their
+// search depth (state - GOAL_IN_PROGRESS) so cycles can be located.
+#define GOAL_RETRY (-1)   // unknown again after a non-final failure
+#define GOAL_UNKNOWN 0
+#define GOAL_PROVEN 1
+#define GOAL_FAILED 2
+#define GOAL_IN_PROGRESS 3
+
+/**
+ * Prépare le chaînage arrière sur une base déjà compilée.
+ * @param cbc Base compilée.
+ * @return Index initialisé.
+ */
+BackwardIndex backward_index_create(const CompiledBC *cbc) {
+    BackwardIndex idx;
+    idx.cbc = cbc;
+    idx.owned = NULL;
+    idx.nkeys = cbc ? 2 * (size_t)cbc->nsyms : 0;
+    idx.state = (int*)calloc(idx.nkeys ? idx.nkeys : 1, sizeof(int));
+    idx.touched = (size_t*)malloc((idx.nkeys ? idx.nkeys : 1) * sizeof(size_t));
+    idx.ntouched = 0;
+    idx.frames = NULL;
+    idx.nframes = idx.frames_cap = 0;
+    idx.max_depth = 0;
+    return idx;
+}
+
+/**
+ * Compile la base et construit l'index des règles par conclusion.
+ * @param bc Base de connaissances.
+ * @return Index initialisé.
+ */
+BackwardIndex backward_index_build(const BC *bc) {
+    CompiledBC *owned = (CompiledBC*)malloc(sizeof(CompiledBC));
+    *owned = bc_compile(bc);
+    BackwardIndex idx = backward_index_create(owned);
+    idx.owned = owned;
+    return idx;
+}
+
+/**
+ * Libère un index de chaînage arrière.
+ * @param idx Index à libérer.
+ * @return Aucun.
+ */
+void backward_index_free(BackwardIndex *idx) {
+    if (!idx) return;
+    if (idx->owned) {
+        compiled_free(idx->owned);
+        free(idx->owned);
+    }
+    free(idx->state);
+    free(idx->touched);
+    free(idx->frames);
+    idx->frames = NULL;
+    idx->nframes = idx->frames_cap = 0;
+    idx->cbc = NULL; idx->owned = NULL; idx->state = NULL; idx->touched = NULL;
+    idx->nkeys = idx->ntouched = 0;
+}
+
+static void set_state(BackwardIndex *idx, size_t key, int st) {
+    if (idx->state[key] == GOAL_UNKNOWN) idx->touched[idx->ntouched++] = key;
+    idx->state[key] = st;
+}
+
+// One goal being proved: the rule of concl_rules[k] is being tried and
+// its premise j is the sub-goal in progress (frame index = depth)
+struct ProveFrame {
+    size_t key;
+    int id, negated;
+    uint32_t k;
+    uint32_t j;
+    int my_low;    // shallowest unfinished ancestor met so far
+    int sub_low;   // same, for the negated premise being proved
+};
+
+#define PROVE_PUSHED (-1)
+#define PROVE_TOO_DEEP (-2)
+
+// Where a sub-goal of 'f' reports the unfinished ancestors it ran into
+static int *frame_low(const BackwardIndex *idx, struct ProveFrame *f) {
+    const CompiledRule *h = &idx->cbc->rules[idx->cbc->concl_rules[f->k]];
+    return f->j < h->npos ? &f->my_low : &f->sub_low;
+}
+
+/*
+ * Starts proving literal (id, negated) at depth idx->nframes. Returns 1 or
+ * 0 when the answer is known at once (facts, memo, cycle), else pushes a
+ * frame and returns PROVE_PUSHED, or PROVE_TOO_DEEP past idx->max_depth. Meeting an in-progress goal lowers *low
+ * to its depth: a failure that depended on an unfinished ancestor is not
+ * final and is therefore not memoized.
+ */
+static int prove_enter(BackwardIndex *idx, BaseFaits *bf, int id, int negated, int *low) {
+    if (facts_has(bf, id, negated)) return 1;
+    size_t key = 2 * (size_t)id + (size_t)negated;
+    if (id < 0 || key >= idx->nkeys) return 0;
+    int st = idx->state[key];
+    if (st == GOAL_PROVEN) return 1;
+    if (st == GOAL_FAILED) return 0;
+    if (st >= GOAL_IN_PROGRESS) {
+        if (st - GOAL_IN_PROGRESS < *low) *low = st - GOAL_IN_PROGRESS;
+        return 0;
+    }
+    if (idx->max_depth && idx->nframes >= idx->max_depth) return PROVE_TOO_DEEP;
+    set_state(idx, key, GOAL_IN_PROGRESS + (int)idx->nframes);
+    if (idx->nframes == idx->frames_cap) {
+        idx->frames_cap = idx->frames_cap ? idx->frames_cap * 2 : 64;
+        idx->frames = (struct ProveFrame*)realloc(idx->frames, idx->frames_cap * sizeof(struct ProveFrame));
+    }
+    struct ProveFrame *f = &idx->frames[idx->nframes++];
+    f->key = key;
+    f->id = id;
+    f->negated = negated;
+    f->k = idx->cbc->concl_start[key];
+    f->j = 0;
+    f->my_low = INT_MAX;
+    f->sub_low = INT_MAX;
+    return PROVE_PUSHED;
+}
+
+// Depth-first search with an explicit frame stack: long chains would
+// overflow a recursive walk
+static int prove(BackwardIndex *idx, BaseFaits *bf, int id, int negated) {
+    const CompiledBC *cbc = idx->cbc;
+    int root_low = INT_MAX;
+    int ret = prove_enter(idx, bf, id, negated, &root_low);
+    while (idx->nframes > 0) {
+        if (ret == PROVE_TOO_DEEP) {
+            // Give up: backward_prove resets the memo of every open goal
+            idx->nframes = 0;
+            break;
+        }
+        struct ProveFrame *f = &idx->frames[idx->nframes - 1];
+        int depth = (int)idx->nframes - 1;
+        if (ret != PROVE_PUSHED) {
+            // Premise j of the current rule has just been settled
+            const CompiledRule *h = &cbc->rules[cbc->concl_rules[f->k]];
+            int ok = ret;
+            if (f->j >= h->npos) {
+                // ¬P holds only if P definitely fails; a failure that hinges
+                // on an unfinished ancestor (negative cycle) is unknown.
+                ok = !ret && f->sub_low > depth;
+                if (f->sub_low < f->my_low) f->my_low = f->sub_low;
+            }
+            if (ok) {
+                f->j++;
+            } else {
+                f->k++;
+                f->j = 0;
+            }
+        }
+        if (f->k < cbc->concl_start[f->key + 1]) {
+            const CompiledRule *h = &cbc->rules[cbc->concl_rules[f->k]];
+            if (f->j < h->npos + h->nneg) {
+                f->sub_low = INT_MAX;
+                // May move the frames: 'f' is not used past this call
+                ret = prove_enter(idx, bf, LIT_ID(cbc->premises[h->start + f->j]), 0, frame_low(idx, f));
+                continue;
+            }
+            // Every premise of the rule holds
+            idx->state[f->key] = GOAL_PROVEN;
+            facts_add(bf, proposition_from_id(f->id, f->negated));
+            idx->nframes--;
+            ret = 1;
+            continue;
+        }
+        // No rule concludes the goal
+        size_t key = f->key;
+        int my_low = f->my_low;
+        idx->nframes--;
+        int *low = idx->nframes > 0 ? frame_low(idx, &idx->frames[idx->nframes - 1]) : &root_low;
+        if (my_low < depth) {
+            idx->state[key] = GOAL_RETRY;
+            if (my_low < *low) *low = my_low;
+        } else {
+            idx->state[key] = GOAL_FAILED;
+        }
+        ret = 0;
+    }
+    return ret == PROVE_TOO_DEEP ? -1 : ret;
+}
+
+/**
+ * Prouve un but par chaînage arrière à partir d'un index préconstruit.
+ * @param idx Index des règles par conclusion.
+ * @param bf Base de faits; les sous-buts prouvés y sont ajoutés.
+ * @param goal But à prouver.
+ * @return 1 si le but est prouvé, 0 sinon, -1 au-delà de idx->max_depth.
+ */
+int backward_prove(BackwardIndex *idx, BaseFaits *bf, Proposition goal) {
+    if (!idx || !bf || goal.id == SYMBOL_NONE) return 0;
+    int ok = prove(idx, bf, goal.id, goal.negated);
+    // Failed sub-goals are only valid for the current facts: reset the memo
+    for (size_t i = 0; i < idx->ntouched; ++i) idx->state[idx->touched[i]] = GOAL_UNKNOWN;
+    idx->ntouched = 0;
+    return ok;
+}
+
+/**
+ * Chaînage arrière avec index temporaire.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits; les sous-buts prouvés y sont ajoutés.
+ * @param goal But à prouver.
+ * @return 1 si le but est prouvé, 0 sinon.
+ */
+int inference_backward_chain(const BC *bc, BaseFaits *bf, Proposition goal) {
+    if (!bc || !bf) return 0;
+    BackwardIndex idx = backward_index_build(bc);
+    int ok = backward_prove(&idx, bf, goal);
+    backward_index_free(&idx);
+    return ok;
+}
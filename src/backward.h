@@ -0,0 +1,69 @@
+#pragma once
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+
+// Chaînage arrière sur une base compilée (index des règles par littéral
+// conclu), avec l'état de mémoïsation réutilisé d'une requête à l'autre.
+// Non partageable entre threads.
+typedef struct BackwardIndex {
+    const CompiledBC *cbc; // base interrogée
+    CompiledBC *owned;     // base compilée possédée (backward_index_build), sinon NULL
+    size_t nkeys;          // 2 * nombre de symboles (clé: 2*id + negated)
+    int *state;            // état de chaque sous-but (voir backward.c)
+    size_t *touched;       // clés modifiées pendant la requête courante
+    size_t ntouched;
+    struct ProveFrame *frames; // pile de la recherche en profondeur (voir backward.c)
+    size_t nframes;
+    size_t frames_cap;
+    size_t max_depth;      // profondeur maximale d'une preuve (0: sans limite)
+} BackwardIndex;
+
+/**
+ * Compile la base et construit l'index des règles par conclusion.
+ * L'index reste valide tant que la base de connaissances n'est pas modifiée.
+ * @param bc Base de connaissances.
+ * @return Index initialisé.
+ */
+BackwardIndex backward_index_build(const BC *bc);
+
+/**
+ * Prépare le chaînage arrière sur une base déjà compilée (non copiée:
+ * elle doit survivre à l'index).
+ * @param cbc Base compilée.
+ * @return Index initialisé.
+ */
+BackwardIndex backward_index_create(const CompiledBC *cbc);
+
+/**
+ * Libère un index de chaînage arrière.
+ * @param idx Index à libérer.
+ * @return Aucun.
+ */
+void backward_index_free(BackwardIndex *idx);
+
+/**
+ * Prouve un but par chaînage arrière à partir d'un index préconstruit.
+ * Le coût est proportionnel au sous-graphe des règles pertinentes pour le but.
+ * La pile de sous-buts est sur le tas: seule idx->max_depth la borne.
+ * @param idx Index des règles par conclusion.
+ * @param bf Base de faits; les sous-buts prouvés y sont ajoutés.
+ * @param goal But à prouver.
+ * @return 1 si le but est prouvé, 0 sinon, -1 si la preuve dépasse
+ *         idx->max_depth sous-buts imbriqués (recherche abandonnée).
+ */
+int backward_prove(BackwardIndex *idx, BaseFaits *bf, Proposition goal);
+
+/**
+ * Chaînage arrière: prouve un but en résolvant récursivement les règles
+ * qui le concluent. Les sous-buts prouvés et échoués sont mémoïsés, les
+ * cycles détectés, et une prémisse ¬X est satisfaite si X ne peut pas être
+ * prouvé (négation par l'échec).
+ * Construit un index temporaire: pour des requêtes répétées sur la même base,
+ * préférer backward_index_build + backward_prove.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits; les sous-buts prouvés y sont ajoutés.
+ * @param goal But à prouver.
+ * @return 1 si le but est prouvé, 0 sinon.
+ */
+int inference_backward_chain(const BC *bc, BaseFaits *bf, Proposition goal);
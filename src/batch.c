@@ -0,0 +1,157 @@
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+
+/**
+ * Crée un bloc de scénarios vide pour une base compilée.
+ * @param cbc Base compilée.
+ * @param record 1 pour journaliser les déclenchements, 0 sinon.
+ * @return Bloc initialisé.
+ */
+BatchBlock batch_block_create(const CompiledBC *cbc, int record) {
+    BatchBlock b;
+    memset(&b, 0, sizeof(b));
+    b.cbc = cbc;
+    b.nkeys = cbc ? 2 * (size_t)cbc->nsyms : 0;
+    b.lanes = (uint64_t*)calloc((b.nkeys ? b.nkeys : 1) * BATCH_WORDS, sizeof(uint64_t));
+    b.record = record;
+    return b;
+}
+
+/**
+ * Remet tous les littéraux à faux et vide le journal.
+ * @param b Bloc.
+ * @return Aucun.
+ */
+void batch_block_clear(BatchBlock *b) {
+    if (!b) return;
+    memset(b->lanes, 0, b->nkeys * BATCH_WORDS * sizeof(uint64_t));
+    b->log_len = 0;
+}
+
+static void log_firing(BatchBlock *b, uint32_t rule, const uint64_t *mask) {
+    if (b->log_len == b->log_cap) {
+        b->log_cap = b->log_cap ? b->log_cap * 2 : 64;
+        b->log = (BatchFiring*)realloc(b->log, b->log_cap * sizeof(BatchFiring));
+    }
+    BatchFiring *f = &b->log[b->log_len++];
+    f->rule = rule;
+    memcpy(f->mask, mask, sizeof(f->mask));
+}
+
+/**
+ * Chaînage avant sur les scénarios du bloc.
+ * @param b Bloc dont les masques contiennent les faits de base.
+ * @return Nombre de passes effectuées.
+ */
+size_t batch_block_run(BatchBlock *b) {
+    if (!b || !b->cbc) return 0;
+    const CompiledBC *cbc = b->cbc;
+    size_t passes = 0;
+    uint64_t changed;
+    do {
+        changed = 0;
+        passes++;
+        for (uint32_t r = 0; r < cbc->nrules; ++r) {
+            const CompiledRule *h = &cbc->rules[r];
+            const uint32_t *lit = cbc->premises + h->start;
+            uint64_t *concl = b->lanes + (size_t)cbc->conclusions[r] * BATCH_WORDS;
+            // Scenarios where the conclusion is still missing...
+            uint64_t m[BATCH_WORDS];
+            for (int w = 0; w < BATCH_WORDS; ++w) m[w] = ~concl[w];
+            // ...and every premise holds. Premises only read the positive
+            // plane: ¬X holds when X is absent (key 2*id).
+            for (uint32_t k = 0; k < h->npos; ++k) {
+                const uint64_t *x = b->lanes + (size_t)(lit[k] & ~1u) * BATCH_WORDS;
+                for (int w = 0; w < BATCH_WORDS; ++w) m[w] &= x[w];
+            }
+            for (uint32_t k = h->npos; k < h->npos + h->nneg; ++k) {
+                const uint64_t *x = b->lanes + (size_t)(lit[k] & ~1u) * BATCH_WORDS;
+                for (int w = 0; w < BATCH_WORDS; ++w) m[w] &= ~x[w];
+            }
+            uint64_t any = 0;
+            for (int w = 0; w < BATCH_WORDS; ++w) {
+                concl[w] |= m[w];
+                any |= m[w];
+            }
+            if (any && b->record) log_firing(b, r, m);
+            changed |= any;
+        }
+        // A scenario that is already stable is left untouched by further
+        // passes, so iterating until no lane moves matches the naive engine.
+    } while (changed);
+    return passes;
+}
+
+/**
+ * Libère un bloc de scénarios.
+ * @param b Bloc à libérer.
+ * @return Aucun.
+ */
+void batch_block_free(BatchBlock *b) {
+    if (!b) return;
+    free(b->lanes);
+    free(b->log);
+    memset(b, 0, sizeof(*b));
+}
+
+/**
+ * Calcule la clôture de n bases de faits sur une base compilée.
+ * @param cbc Base compilée.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées).
+ * @param n Nombre de scénarios.
+ * @return Aucun.
+ */
+void inference_batch_compiled(const CompiledBC *cbc, const BaseFaits *inputs, BaseFaits *outputs, size_t n) {
+    if (!cbc || !inputs || !outputs) return;
+    BatchBlock b = batch_block_create(cbc, 1);
+    for (size_t base = 0; base < n; base += BATCH_WIDTH) {
+        size_t count = n - base < BATCH_WIDTH ? n - base : BATCH_WIDTH;
+        batch_block_clear(&b);
+        for (size_t s = 0; s < count; ++s) {
+            size_t it = 0;
+            Proposition p;
+            while (facts_next(&inputs[base + s], &it, &p)) {
+                // Facts on symbols unknown to the rules cannot fire anything
+                if ((size_t)p.id >= cbc->nsyms) continue;
+                batch_lane(&b, p.id, p.negated)[s >> 6] |= (uint64_t)1 << (s & 63);
+            }
+        }
+        batch_block_run(&b);
+
+        for (size_t s = 0; s < count; ++s) {
+            outputs[base + s] = facts_copy(&inputs[base + s]);
+            facts_reserve(&outputs[base + s], cbc->nsyms);
+        }
+        // Replaying the log keeps the naive insertion order in each closure
+        for (size_t e = 0; e < b.log_len; ++e) {
+            uint32_t c = cbc->conclusions[b.log[e].rule];
+            Proposition p = proposition_from_id(LIT_ID(c), LIT_NEG(c));
+            for (int w = 0; w < BATCH_WORDS; ++w) {
+                uint64_t bits = b.log[e].mask[w];
+                while (bits) {
+                    size_t s = (size_t)w * 64 + (size_t)__builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    if (s < count) facts_add(&outputs[base + s], p);
+                }
+            }
+        }
+    }
+    batch_block_free(&b);
+}
+
+/**
+ * Calcule la clôture de n bases de faits.
+ * @param bc Base de connaissances.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées).
+ * @param n Nombre de scénarios.
+ * @return Aucun.
+ */
+void inference_batch(const BC *bc, const BaseFaits *inputs, BaseFaits *outputs, size_t n) {
+    if (!bc) return;
+    CompiledBC cbc = bc_compile(bc);
+    inference_batch_compiled(&cbc, inputs, outputs, n);
+    compiled_free(&cbc);
+}
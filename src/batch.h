@@ -0,0 +1,94 @@
+#pragma once
+#include <stdint.h>
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+
+// Inférence par tranches de bits: chaque littéral (clé 2*id + negated)
+// porte un masque de BATCH_WIDTH bits, un bit par scénario. Une règle est
+// évaluée pour tous les scénarios d'un bloc par une suite de ET / ET-NON.
+#define BATCH_WORDS 4
+#define BATCH_WIDTH (64 * BATCH_WORDS)
+
+// Déclenchement d'une règle dans un bloc: scénarios où elle a conclu.
+typedef struct BatchFiring {
+    uint32_t rule;
+    uint64_t mask[BATCH_WORDS];
+} BatchFiring;
+
+// Bloc de BATCH_WIDTH scénarios évalués ensemble. Réutilisable d'un bloc à
+// l'autre (batch_block_clear); non partageable entre threads.
+typedef struct BatchBlock {
+    const CompiledBC *cbc;
+    size_t nkeys;          // 2 * nombre de symboles compilés
+    uint64_t *lanes;       // clé -> BATCH_WORDS mots (bit s: vrai dans le scénario s)
+    int record;            // 1: journaliser les déclenchements (ordre de déduction)
+    BatchFiring *log;
+    size_t log_len;
+    size_t log_cap;
+} BatchBlock;
+
+/**
+ * Crée un bloc de scénarios vide pour une base compilée.
+ * @param cbc Base compilée (doit survivre au bloc).
+ * @param record 1 pour journaliser les déclenchements, 0 sinon.
+ * @return Bloc initialisé, à libérer avec batch_block_free.
+ */
+BatchBlock batch_block_create(const CompiledBC *cbc, int record);
+
+/**
+ * Remet tous les littéraux à faux et vide le journal.
+ * @param b Bloc.
+ * @return Aucun.
+ */
+void batch_block_clear(BatchBlock *b);
+
+/**
+ * Accède au masque d'un littéral.
+ * @param b Bloc.
+ * @param id Identifiant du symbole (< nombre de symboles compilés).
+ * @param negated 1 pour ¬id, 0 sinon.
+ * @return Pointeur vers BATCH_WORDS mots.
+ */
+static inline uint64_t *batch_lane(BatchBlock *b, int id, int negated) {
+    return b->lanes + (2 * (size_t)id + (size_t)(negated ? 1 : 0)) * BATCH_WORDS;
+}
+
+/**
+ * Chaînage avant sur les scénarios du bloc. Les règles sont parcourues dans
+ * l'ordre de la base jusqu'à stabilité, comme inference_forward_chain: le
+ * résultat de chaque scénario est identique à celui du moteur naïf.
+ * @param b Bloc dont les masques contiennent les faits de base.
+ * @return Nombre de passes effectuées.
+ */
+size_t batch_block_run(BatchBlock *b);
+
+/**
+ * Libère un bloc de scénarios.
+ * @param b Bloc à libérer.
+ * @return Aucun.
+ */
+void batch_block_free(BatchBlock *b);
+
+/**
+ * Calcule la clôture de n bases de faits sur une base compilée.
+ * outputs[i] reçoit une copie de inputs[i] complétée des faits déduits,
+ * dans l'ordre où le moteur naïf les aurait ajoutés.
+ * @param cbc Base compilée.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées, à libérer avec facts_free).
+ * @param n Nombre de scénarios.
+ * @return Aucun.
+ */
+void inference_batch_compiled(const CompiledBC *cbc, const BaseFaits *inputs, BaseFaits *outputs, size_t n);
+
+/**
+ * Calcule la clôture de n bases de faits (compile la base puis évalue
+ * les scénarios par blocs de BATCH_WIDTH).
+ * @param bc Base de connaissances.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées, à libérer avec facts_free).
+ * @param n Nombre de scénarios.
+ * @return Aucun.
+ */
+void inference_batch(const BC *bc, const BaseFaits *inputs, BaseFaits *outputs, size_t n);
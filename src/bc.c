@@ -1,11 +1,130 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include "bc.h"
+#include "version.h"
+
+// Rules touching one symbol. Rules concluding it are chained through their
+// nodes (concl_next/concl_prev) in base order; rules using it in a premise
+// are an unordered array, only kept once a cascade has needed them.
+typedef struct SymbolRefs {
+    ListRegleNode *first, *last;  // rules concluding the symbol
+    uint32_t nconcl;
+    uint32_t nuses, cap_uses;
+    int erased;                   // queued by the running cascade
+    ListRegleNode **uses;         // rules with the symbol in their premise, once each
+} SymbolRefs;
+
+struct BCIndex {
+    SymbolRefs *syms;             // indexed by symbol id
+    size_t nsyms;
+    int has_uses;                 // premise side built (see bc_remove_symbol_cascade)
+};
+
+static void refs_push(ListRegleNode ***arr, uint32_t *n, uint32_t *cap, ListRegleNode *node) {
+    if (*n == *cap) {
+        *cap = *cap ? *cap * 2 : 4;
+        *arr = (ListRegleNode**)realloc(*arr, *cap * sizeof(ListRegleNode*));
+    }
+    (*arr)[(*n)++] = node;
+}
+
+// Swap-removes one occurrence of node, in O(n)
+static void refs_remove(ListRegleNode **arr, uint32_t *n, const ListRegleNode *node) {
+    for (uint32_t i = *n; i-- > 0;) {
+        if (arr[i] == node) {
+            arr[i] = arr[--*n];
+            return;
+        }
+    }
+}
+
+static SymbolRefs *index_refs(BCIndex *idx, int id) {
+    if ((size_t)id >= idx->nsyms) {
+        size_t n = idx->nsyms ? idx->nsyms : 16;
+        while (n <= (size_t)id) n *= 2;
+        idx->syms = (SymbolRefs*)realloc(idx->syms, n * sizeof(SymbolRefs));
+        memset(idx->syms + idx->nsyms, 0, (n - idx->nsyms) * sizeof(SymbolRefs));
+        idx->nsyms = n;
+    }
+    return &idx->syms[id];
+}
+
+static void index_add_uses(BCIndex *idx, ListRegleNode *node) {
+    for (const ListPropositionNode *pn = node->value.premises.head; pn; pn = pn->next) {
+        if (pn->value.id == SYMBOL_NONE) continue;
+        SymbolRefs *r = index_refs(idx, pn->value.id);
+        // A rule's premises are indexed together: a repeated symbol would
+        // find this rule last in its array.
+        if (r->nuses == 0 || r->uses[r->nuses - 1] != node) refs_push(&r->uses, &r->nuses, &r->cap_uses, node);
+    }
+}
+
+static void index_add_rule(BCIndex *idx, ListRegleNode *node) {
+    node->concl_next = node->concl_prev = NULL;
+    if (regle_has_conclusion(&node->value)) {
+        SymbolRefs *r = index_refs(idx, regle_get_conclusion(&node->value).id);
+        node->concl_prev = r->last;
+        if (r->last) r->last->concl_next = node; else r->first = node;
+        r->last = node;
+        r->nconcl++;
+    }
+    if (idx->has_uses) index_add_uses(idx, node);
+}
+
+static void index_remove_rule(BCIndex *idx, ListRegleNode *node) {
+    if (regle_has_conclusion(&node->value)) {
+        SymbolRefs *r = &idx->syms[regle_get_conclusion(&node->value).id];
+        if (node->concl_prev) node->concl_prev->concl_next = node->concl_next; else r->first = node->concl_next;
+        if (node->concl_next) node->concl_next->concl_prev = node->concl_prev; else r->last = node->concl_prev;
+        node->concl_next = node->concl_prev = NULL;
+        r->nconcl--;
+    }
+    if (!idx->has_uses) return;
+    for (const ListPropositionNode *pn = node->value.premises.head; pn; pn = pn->next) {
+        if (pn->value.id == SYMBOL_NONE || (size_t)pn->value.id >= idx->nsyms) continue;
+        SymbolRefs *r = &idx->syms[pn->value.id];
+        refs_remove(r->uses, &r->nuses, node);
+    }
+}
+
+static void index_free(BCIndex *idx) {
+    if (!idx) return;
+    for (size_t i = 0; i < idx->nsyms; ++i) free(idx->syms[i].uses);
+    free(idx->syms);
+    free(idx);
+}
+
+// Rules concluding a symbol, NULL if none (or no index)
+static const SymbolRefs *index_find(const BC *bc, int id) {
+    if (!bc || !bc->index || id < 0 || (size_t)id >= bc->index->nsyms) return NULL;
+    return &bc->index->syms[id];
+}
+
+// Unlinks a rule from the base and its index; the caller owns the rule and,
+// without an arena, the node.
+static void bc_detach(BC *bc, ListRegleNode *node) {
+    if (bc->index) index_remove_rule(bc->index, node);
+    if (bc->current) version_remove_rule(bc->current, node);
+    listr_unlink(&bc->regles, node);
+    if (node->value.premises.arena != bc->arena && bc->heap_rules > 0) bc->heap_rules--;
+}
 
 /**
  * Crée une base de connaissances vide.
  * @return Base de connaissances initialisée.
  */
 BC bc_create() {
-    BC bc; bc.regles = listr_create(); return bc;
+    BC bc;
+    // The arena lives on the heap: lists keep a pointer to it and BC is
+    // passed around by value.
+    bc.arena = (Arena*)malloc(sizeof(Arena));
+    *bc.arena = arena_create(0);
+    bc.regles = listr_create_in(bc.arena);
+    bc.heap_rules = 0;
+    bc.index = (BCIndex*)calloc(1, sizeof(BCIndex));
+    bc.current = NULL;
+    return bc;
 }
 
 /**
@@ -15,7 +134,42 @@ BC bc_create() {
  */
 void bc_free(BC *bc) {
     if (!bc) return;
-    listr_free(&bc->regles);
+    index_free(bc->index);
+    bc->index = NULL;
+    if (bc->current) {
+        version_release(bc->current);
+        free(bc->current);
+        bc->current = NULL;
+    }
+    if (bc->heap_rules > 0) {
+        listr_free(&bc->regles);
+    } else {
+        bc->regles = listr_create_in(bc->arena);
+    }
+    if (bc->arena) {
+        arena_free(bc->arena);
+        free(bc->arena);
+        bc->arena = NULL;
+    }
+    bc->regles.arena = NULL;
+    bc->heap_rules = 0;
+}
+
+/**
+ * Copie les règles d'une base dans une nouvelle base.
+ * @param bc Base à copier.
+ * @return Nouvelle base.
+ */
+BC bc_copy(const BC *bc) {
+    BC copy = bc_create();
+    if (!bc) return copy;
+    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
+        Regle r = regle_create_in(copy.arena);
+        for (const ListPropositionNode *p = rn->value.premises.head; p; p = p->next) regle_add_premise(&r, p->value);
+        if (regle_has_conclusion(&rn->value)) regle_set_conclusion(&r, regle_get_conclusion(&rn->value));
+        bc_add_regle(&copy, r);
+    }
+    return copy;
 }
 
 /**
@@ -26,7 +180,10 @@ void bc_free(BC *bc) {
  */
 void bc_add_regle(BC *bc, Regle r) {
     if (!bc) return;
+    if (r.premises.arena != bc->arena) bc->heap_rules++;
     listr_push_back(&bc->regles, r);
+    if (bc->index) index_add_rule(bc->index, bc->regles.tail);
+    if (bc->current) version_add_rule(bc->current, bc->regles.tail);
 }
 
 /**
@@ -40,24 +197,167 @@ int bc_head_regle(const BC *bc, Regle *out) {
     return listr_head(&bc->regles, out);
 }
 
+/**
+ * Supprime une règle précise de la base.
+ * @param bc Base de connaissances.
+ * @param node Nœud de la règle.
+ * @return 1 si supprimée, 0 sinon.
+ */
+int bc_remove_rule(BC *bc, ListRegleNode *node) {
+    if (!bc || !node) return 0;
+    bc_detach(bc, node);
+    regle_free(&node->value);
+    if (!bc->regles.arena) free(node);
+    return 1;
+}
+
+/**
+ * Supprime la première règle dont la conclusion a le nom 'label'.
+ * @param bc Base de connaissances.
+ * @param label Nom de la conclusion.
+ * @return 1 si supprimée, 0 sinon.
+ */
 int bc_remove_rule_by_label(BC *bc, const char *label) {
     if (!bc || !label) return 0;
-    ListRegleNode *prev = NULL, *cur = bc->regles.head;
-    while (cur) {
-        const Regle *r = &cur->value;
-        if (regle_has_conclusion(r)) {
-            Proposition c = regle_get_conclusion(r);
-            if (c.name && strcmp(c.name, label) == 0) {
-                ListRegleNode *next = cur->next;
-                if (prev) prev->next = next; else bc->regles.head = next;
-                if (cur == bc->regles.tail) bc->regles.tail = prev;
-                regle_free(&cur->value);
-                free(cur);
-                bc->regles.size--;
-                return 1;
+    const SymbolRefs *r = index_find(bc, symbol_lookup(label));
+    if (!r || !r->first) return 0;
+    return bc_remove_rule(bc, r->first);
+}
+
+/**
+ * Donne la première règle (dans l'ordre de la base) concluant un symbole.
+ * @param bc Base de connaissances.
+ * @param id Identifiant du symbole.
+ * @return Nœud de la règle, NULL si aucune.
+ */
+const ListRegleNode *bc_rules_concluding(const BC *bc, int id) {
+    const SymbolRefs *r = index_find(bc, id);
+    return r ? r->first : NULL;
+}
+
+/**
+ * Compte les règles concluant un symbole.
+ * @param bc Base de connaissances.
+ * @param id Identifiant du symbole.
+ * @return Nombre de règles.
+ */
+size_t bc_count_concluding(const BC *bc, int id) {
+    const SymbolRefs *r = index_find(bc, id);
+    return r ? r->nconcl : 0;
+}
+
+// Worklist of the symbols erased by one cascade
+typedef struct Cascade {
+    BC *bc;
+    ListRegle *removed;
+    int *queue;
+    size_t head, len, cap;
+    size_t nremoved;
+} Cascade;
+
+// Indexes every rule's premises, once per base
+static void index_build_uses(BC *bc) {
+    BCIndex *idx = bc->index;
+    if (idx->has_uses) return;
+    idx->has_uses = 1;
+    for (ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) index_add_uses(idx, rn);
+}
+
+static void cascade_push(Cascade *cs, int id) {
+    SymbolRefs *r = index_refs(cs->bc->index, id);
+    if (r->erased) return;
+    r->erased = 1;
+    if (cs->len == cs->cap) {
+        cs->cap = cs->cap ? cs->cap * 2 : 16;
+        cs->queue = (int*)realloc(cs->queue, cs->cap * sizeof(int));
+    }
+    cs->queue[cs->len++] = id;
+}
+
+static void cascade_remove_rule(Cascade *cs, ListRegleNode *node) {
+    BC *bc = cs->bc;
+    bc_detach(bc, node);
+    int has_concl = regle_has_conclusion(&node->value);
+    int c = has_concl ? regle_get_conclusion(&node->value).id : SYMBOL_NONE;
+    if (cs->removed) listr_push_back(cs->removed, node->value);
+    else regle_free(&node->value);
+    if (!bc->regles.arena) free(node);
+    cs->nremoved++;
+    // A symbol no rule concludes any more is erased in turn
+    if (has_concl && bc->index->syms[c].nconcl == 0) cascade_push(cs, c);
+}
+
+/**
+ * Supprime un symbole et, en cascade, les règles et symboles qui en dépendent.
+ * @param bc Base de connaissances.
+ * @param id Identifiant du symbole.
+ * @param removed Sortie optionnelle: reçoit les règles retirées.
+ * @return Nombre de règles retirées.
+ */
+size_t bc_remove_symbol_cascade(BC *bc, int id, ListRegle *removed) {
+    if (!bc || !bc->index || id < 0 || id >= symbol_count()) return 0;
+    index_build_uses(bc);
+    Cascade cs;
+    memset(&cs, 0, sizeof(cs));
+    cs.bc = bc;
+    cs.removed = removed;
+    cascade_push(&cs, id);
+    while (cs.head < cs.len) {
+        int s = cs.queue[cs.head++];
+        // Rules defining the symbol go first (only the starting one has any)
+        while (bc->index->syms[s].first) cascade_remove_rule(&cs, bc->index->syms[s].first);
+        // Then the symbol leaves every premise it appears in; detaching the
+        // array is enough to drop those index entries.
+        SymbolRefs *r = &bc->index->syms[s];
+        ListRegleNode **uses = r->uses;
+        uint32_t nuses = r->nuses;
+        r->uses = NULL;
+        r->nuses = r->cap_uses = 0;
+        for (uint32_t i = 0; i < nuses; ++i) {
+            ListRegleNode *u = uses[i];
+            listp_remove_all_by_id(&u->value.premises, s);
+            if (listp_is_empty(&u->value.premises)) cascade_remove_rule(&cs, u);
+            else if (bc->current) version_update_rule(bc->current, u);
+        }
+        free(uses);
+    }
+    for (size_t i = 0; i < cs.len; ++i) bc->index->syms[cs.queue[i]].erased = 0;
+    free(cs.queue);
+    return cs.nremoved;
+}
+
+static int cmp_symbol_name(const void *a, const void *b) {
+    return strcmp(symbol_name(*(const int*)a), symbol_name(*(const int*)b));
+}
+
+/**
+ * Collecte les entrées de la base (prémisses jamais conclues).
+ * @param bc Base de connaissances.
+ * @param out Sortie: identifiants triés par nom (à libérer avec free).
+ * @return Nombre d'entrées.
+ */
+size_t bc_input_symbols(const BC *bc, int **out) {
+    if (!out) return 0;
+    *out = NULL;
+    if (!bc) return 0;
+    size_t nsyms = (size_t)symbol_count();
+    unsigned char *seen = (unsigned char*)calloc(nsyms ? nsyms : 1, 1);
+    size_t n = 0, cap = 0;
+    int *ids = NULL;
+    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
+        for (const ListPropositionNode *pn = rn->value.premises.head; pn; pn = pn->next) {
+            int id = pn->value.id;
+            if (id == SYMBOL_NONE || seen[id] || bc_count_concluding(bc, id) > 0) continue;
+            seen[id] = 1;
+            if (n == cap) {
+                cap = cap ? cap * 2 : 16;
+                ids = (int*)realloc(ids, cap * sizeof(int));
             }
+            ids[n++] = id;
         }
-        prev = cur; cur = cur->next;
     }
-    return 0;
+    free(seen);
+    if (n > 1) qsort(ids, n, sizeof(int), cmp_symbol_name);
+    *out = ids;
+    return n;
 }
@@ -1,8 +1,19 @@
 #pragma once
 #include "list_regle.h"
 
+// Index inverse des règles par symbole (voir bc.c).
+typedef struct BCIndex BCIndex;
+// Version figée de la base (voir version.h).
+typedef struct BCVersion BCVersion;
+
 typedef struct BC {
     ListRegle regles;
+    Arena *arena;       // nœuds de règles (et prémisses créées avec regle_create_in)
+    size_t heap_rules;  // règles dont la prémisse n'est pas dans l'arène
+    BCIndex *index;     // symbole -> règles qui le concluent (et l'utilisent,
+                        // après une première suppression en cascade)
+    BCVersion *current; // version courante si l'historique est actif
+                        // (bc_enable_versions), NULL sinon
 } BC;
 
 /**
@@ -12,14 +23,24 @@ typedef struct BC {
 BC bc_create();
 
 /**
- * Libère une base de connaissances.
+ * Libère une base de connaissances. Les nœuds alloués dans l'arène sont
+ * rendus en bloc; seules les prémisses hors arène sont parcourues.
  * @param bc Pointeur vers la base.
  * @return Aucun.
  */
 void bc_free(BC *bc);
 
 /**
- * Ajoute une règle à la base (en queue).
+ * Copie les règles d'une base dans une nouvelle base (arène propre, sans
+ * historique de versions).
+ * @param bc Base à copier.
+ * @return Nouvelle base, à libérer avec bc_free.
+ */
+BC bc_copy(const BC *bc);
+
+/**
+ * Ajoute une règle à la base (en queue). Pour éviter toute allocation
+ * individuelle, créer la règle avec regle_create_in(bc->arena).
  * @param bc Base de connaissances.
  * @param r Règle à ajouter.
  * @return Aucun.
@@ -35,9 +56,66 @@ void bc_add_regle(BC *bc, Regle r);
 int bc_head_regle(const BC *bc, Regle *out);
 
 /**
- * Supprime la première règle dont la conclusion a le nom 'label'.
+ * Supprime une règle précise de la base, en temps constant attendu.
+ * @param bc Base de connaissances.
+ * @param node Nœud de la règle, appartenant à bc->regles.
+ * @return 1 si supprimée, 0 sinon.
+ */
+int bc_remove_rule(BC *bc, ListRegleNode *node);
+
+/**
+ * Supprime la première règle dont la conclusion a le nom 'label', en temps
+ * constant attendu (table des symboles puis index des conclusions).
  * @param bc Base de connaissances.
  * @param label Nom de la conclusion de la règle à supprimer.
  * @return 1 si supprimée, 0 sinon.
  */
 int bc_remove_rule_by_label(BC *bc, const char *label);
+
+/**
+ * Donne la première règle, dans l'ordre de la base, qui conclut un symbole;
+ * les suivantes s'obtiennent par le champ concl_next des nœuds. Temps
+ * constant, l'index étant tenu à jour par bc_add_regle et les suppressions.
+ * @param bc Base de connaissances.
+ * @param id Identifiant du symbole.
+ * @return Nœud de la règle, NULL si aucune règle ne le conclut.
+ */
+const ListRegleNode *bc_rules_concluding(const BC *bc, int id);
+
+/**
+ * Compte les règles qui concluent un symbole, en temps constant.
+ * @param bc Base de connaissances.
+ * @param id Identifiant du symbole.
+ * @return Nombre de règles (0: le symbole n'est conclu par aucune règle).
+ */
+size_t bc_count_concluding(const BC *bc, int id);
+
+/**
+ * Supprime un symbole de la base et tout ce qui en dépend: les règles qui
+ * le concluent sont retirées et il est ôté des prémisses (positives et
+ * négées) des autres règles. Une règle dont la prémisse devient vide est
+ * retirée à son tour, et un symbole qui n'est plus conclu par aucune règle
+ * est supprimé de la même manière, jusqu'à clôture. Les règles sans
+ * prémisse au départ sont conservées.
+ * Le premier appel complète l'index de la base avec les prémisses (un
+ * parcours), tenu à jour ensuite par bc_add_regle et
+ * bc_remove_rule_by_label; chaque cascade est alors linéaire dans le
+ * sous-graphe touché.
+ * @param bc Base de connaissances.
+ * @param id Identifiant du symbole à supprimer.
+ * @param removed Sortie optionnelle: liste (créée avec listr_create) qui
+ *        reçoit les règles retirées, dans l'ordre de retrait, à libérer avec
+ *        listr_free. Leurs prémisses allouées dans l'arène de la base restent
+ *        valides jusqu'à bc_free. NULL: les règles sont libérées.
+ * @return Nombre de règles retirées.
+ */
+size_t bc_remove_symbol_cascade(BC *bc, int id, ListRegle *removed);
+
+/**
+ * Collecte les entrées de la base: symboles apparaissant en prémisse
+ * (positive ou négée) sans être la conclusion d'aucune règle.
+ * @param bc Base de connaissances.
+ * @param out Sortie: tableau des identifiants triés par nom (à libérer avec free).
+ * @return Nombre d'entrées.
+ */
+size_t bc_input_symbols(const BC *bc, int **out);
@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <string.h>
+#include "compiled.h"
+
+// Carves 'count' elements of 'size' bytes out of the storage block
+static void *carve(char **cursor, size_t count, size_t size) {
+    void *p = *cursor;
+    size_t bytes = (count * size + 7) & ~(size_t)7;
+    *cursor += bytes;
+    return p;
+}
+
+static size_t carve_size(size_t count, size_t size) {
+    return (count * size + 7) & ~(size_t)7;
+}
+
+// Points every array of 'c' into 'block' (layout shared with snapshots);
+// neg_rules is left to the caller as it depends on pos_start[nsyms].
+static void carve_layout(CompiledBC *c, char *block, size_t nrules, size_t nsyms, size_t npremises) {
+    char *cur = block;
+    c->nrules = (uint32_t)nrules;
+    c->nsyms = (uint32_t)nsyms;
+    c->npremises = (uint32_t)npremises;
+    c->rules = (const CompiledRule*)carve(&cur, nrules, sizeof(CompiledRule));
+    c->premises = (const uint32_t*)carve(&cur, npremises, sizeof(uint32_t));
+    c->conclusions = (const uint32_t*)carve(&cur, nrules, sizeof(uint32_t));
+    c->pos_start = (const uint32_t*)carve(&cur, nsyms + 1, sizeof(uint32_t));
+    c->neg_start = (const uint32_t*)carve(&cur, nsyms + 1, sizeof(uint32_t));
+    c->pos_rules = (const uint32_t*)carve(&cur, npremises, sizeof(uint32_t));
+    c->concl_start = (const uint32_t*)carve(&cur, 2 * nsyms + 1, sizeof(uint32_t));
+    c->concl_rules = (const uint32_t*)carve(&cur, nrules, sizeof(uint32_t));
+}
+
+static int cmp_symbol_name(const void *a, const void *b) {
+    return strcmp(symbol_name(*(const int*)a), symbol_name(*(const int*)b));
+}
+
+// Turns per-bucket counts (shifted by one) into CSR offsets
+static void prefix_sum(uint32_t *start, size_t n) {
+    for (size_t i = 0; i < n; ++i) start[i + 1] += start[i];
+}
+
+// Fills the CSR block rule by rule; shared by every compiled source
+typedef struct CompileWriter {
+    CompiledBC c;
+    size_t nsyms;
+    size_t total;
+    char *block;
+    // The block is ours: write through the const views while building
+    CompiledRule *rules;
+    uint32_t *premises, *conclusions, *pos_start, *neg_start, *concl_start;
+    uint32_t r, at;
+} CompileWriter;
+
+static void writer_begin(CompileWriter *w, size_t nrules, size_t nsyms, size_t npremises) {
+    memset(w, 0, sizeof(*w));
+    w->nsyms = nsyms;
+    w->total = compiled_storage_size(nrules, nsyms, npremises);
+    w->block = (char*)calloc(1, w->total ? w->total : 1);
+    carve_layout(&w->c, w->block, nrules, nsyms, npremises);
+    w->rules = (CompiledRule*)w->c.rules;
+    w->premises = (uint32_t*)w->c.premises;
+    w->conclusions = (uint32_t*)w->c.conclusions;
+    w->pos_start = (uint32_t*)w->c.pos_start;
+    w->neg_start = (uint32_t*)w->c.neg_start;
+    w->concl_start = (uint32_t*)w->c.concl_start;
+}
+
+// Premises of the current rule: all positives first, then all negated
+static void writer_premise(CompileWriter *w, int id, int neg) {
+    if (w->rules[w->r].npos + w->rules[w->r].nneg == 0) w->rules[w->r].start = w->at;
+    w->premises[w->at++] = LIT_MAKE(id, neg);
+    if (neg) { w->rules[w->r].nneg++; w->neg_start[id + 1]++; }
+    else { w->rules[w->r].npos++; w->pos_start[id + 1]++; }
+}
+
+static void writer_end_rule(CompileWriter *w, Proposition concl) {
+    CompiledRule *h = &w->rules[w->r];
+    if (h->npos + h->nneg == 0) h->start = w->at;
+    w->conclusions[w->r] = LIT_MAKE(concl.id, concl.negated);
+    w->concl_start[w->conclusions[w->r] + 1]++;
+    w->r++;
+}
+
+static CompiledBC writer_finish(CompileWriter *w) {
+    size_t nsyms = w->nsyms;
+    uint32_t nrules = w->c.nrules;
+    CompiledRule *rules = w->rules;
+    uint32_t *premises = w->premises, *conclusions = w->conclusions;
+    uint32_t *pos_start = w->pos_start, *neg_start = w->neg_start, *concl_start = w->concl_start;
+    uint32_t *concl_rules = (uint32_t*)w->c.concl_rules;
+    prefix_sum(pos_start, nsyms);
+    prefix_sum(neg_start, nsyms);
+    prefix_sum(concl_start, 2 * nsyms);
+
+    // Inverted indexes share one array: positives then negated occurrences
+    uint32_t npos_total = pos_start[nsyms];
+    uint32_t *pos_rules = (uint32_t*)w->c.pos_rules;
+    uint32_t *neg_rules = pos_rules + npos_total;
+    uint32_t *pos_fill = (uint32_t*)malloc((nsyms + 1) * sizeof(uint32_t));
+    uint32_t *neg_fill = (uint32_t*)malloc((nsyms + 1) * sizeof(uint32_t));
+    uint32_t *concl_fill = (uint32_t*)malloc((2 * nsyms + 1) * sizeof(uint32_t));
+    memcpy(pos_fill, pos_start, (nsyms + 1) * sizeof(uint32_t));
+    memcpy(neg_fill, neg_start, (nsyms + 1) * sizeof(uint32_t));
+    memcpy(concl_fill, concl_start, (2 * nsyms + 1) * sizeof(uint32_t));
+    for (uint32_t r = 0; r < nrules; ++r) {
+        const CompiledRule *h = &rules[r];
+        for (uint32_t k = 0; k < h->npos + h->nneg; ++k) {
+            uint32_t lit = premises[h->start + k];
+            if (LIT_NEG(lit)) neg_rules[neg_fill[LIT_ID(lit)]++] = r;
+            else pos_rules[pos_fill[LIT_ID(lit)]++] = r;
+        }
+        concl_rules[concl_fill[conclusions[r]]++] = r;
+    }
+    free(concl_fill);
+    free(neg_fill);
+    free(pos_fill);
+
+    CompiledBC c = w->c;
+    c.neg_rules = neg_rules;
+    c.storage = w->block;
+    c.storage_size = w->total;
+    return c;
+}
+
+/**
+ * Compile une base de connaissances en représentation plate et immuable.
+ * @param bc Base de connaissances.
+ * @return Base compilée, à libérer avec compiled_free.
+ */
+CompiledBC bc_compile(const BC *bc) {
+    size_t nrules = 0, npremises = 0;
+    if (bc) {
+        for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
+            if (!regle_has_conclusion(&rn->value)) continue;
+            nrules++;
+            npremises += rn->value.premises.size;
+        }
+    }
+    CompileWriter w;
+    writer_begin(&w, nrules, (size_t)symbol_count(), npremises);
+    if (bc) {
+        for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
+            const Regle *src = &rn->value;
+            if (!regle_has_conclusion(src)) continue;
+            for (int neg = 0; neg <= 1; ++neg) {
+                for (const ListPropositionNode *p = src->premises.head; p; p = p->next) {
+                    if (p->value.negated == neg) writer_premise(&w, p->value.id, neg);
+                }
+            }
+            writer_end_rule(&w, regle_get_conclusion(src));
+        }
+    }
+    return writer_finish(&w);
+}
+
+/**
+ * Compile un tableau de règles à plat.
+ * @param rules Règles, dans l'ordre de la base.
+ * @param nrules Nombre de règles.
+ * @param nsyms Nombre de symboles (identifiants < nsyms).
+ * @return Base compilée, à libérer avec compiled_free.
+ */
+CompiledBC compiled_from_rules(const RuleView *rules, size_t nrules, size_t nsyms) {
+    size_t npremises = 0;
+    for (size_t i = 0; i < nrules; ++i) npremises += rules[i].npremises;
+    CompileWriter w;
+    writer_begin(&w, nrules, nsyms, npremises);
+    for (size_t i = 0; i < nrules; ++i) {
+        for (int neg = 0; neg <= 1; ++neg) {
+            for (uint32_t k = 0; k < rules[i].npremises; ++k) {
+                const Proposition *p = &rules[i].premises[k];
+                if (p->negated == neg) writer_premise(&w, p->id, neg);
+            }
+        }
+        writer_end_rule(&w, rules[i].conclusion);
+    }
+    return writer_finish(&w);
+}
+
+/**
+ * Libère une base compilée.
+ * @param cbc Base compilée.
+ * @return Aucun.
+ */
+void compiled_free(CompiledBC *cbc) {
+    if (!cbc) return;
+    free(cbc->storage);
+    memset(cbc, 0, sizeof(*cbc));
+}
+
+/**
+ * Taille du bloc de stockage d'une base compilée.
+ * @param nrules Nombre de règles.
+ * @param nsyms Nombre de symboles.
+ * @param npremises Nombre total de prémisses.
+ * @return Taille en octets.
+ */
+size_t compiled_storage_size(size_t nrules, size_t nsyms, size_t npremises) {
+    return carve_size(nrules, sizeof(CompiledRule))
+         + carve_size(npremises, sizeof(uint32_t))
+         + carve_size(nrules, sizeof(uint32_t))
+         + 2 * carve_size(nsyms + 1, sizeof(uint32_t))
+         + carve_size(npremises, sizeof(uint32_t))     // pos_rules + neg_rules
+         + carve_size(2 * nsyms + 1, sizeof(uint32_t))
+         + carve_size(nrules, sizeof(uint32_t));
+}
+
+// CSR offsets start at 0, never decrease and end at 'total'
+static int offsets_valid(const uint32_t *start, size_t n, uint32_t total) {
+    if (start[0] != 0) return 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (start[i + 1] < start[i]) return 0;
+    }
+    return start[n] == total;
+}
+
+// One linear pass over a block the writer did not produce in this process:
+// every offset, literal and rule index the engines follow must be in range,
+// and the inverted indexes must match the rules bucket by bucket.
+static int layout_valid(const CompiledBC *c) {
+    size_t nkeys = 2 * (size_t)c->nsyms;
+    uint64_t at = 0;
+    for (uint32_t r = 0; r < c->nrules; ++r) {
+        const CompiledRule *h = &c->rules[r];
+        // Rules are laid out back to back, positives first
+        if (h->start != at) return 0;
+        at += (uint64_t)h->npos + h->nneg;
+        if (at > c->npremises) return 0;
+        for (uint32_t k = 0; k < h->npos + h->nneg; ++k) {
+            uint32_t lit = c->premises[h->start + k];
+            if (lit >= nkeys || LIT_NEG(lit) != (k >= h->npos)) return 0;
+        }
+        if (c->conclusions[r] >= nkeys) return 0;
+    }
+    if (at != c->npremises) return 0;
+    if (!offsets_valid(c->pos_start, c->nsyms, c->pos_start[c->nsyms])
+        || !offsets_valid(c->neg_start, c->nsyms, c->npremises - c->pos_start[c->nsyms])
+        || !offsets_valid(c->concl_start, nkeys, c->nrules)) return 0;
+    for (uint32_t k = 0; k < c->npremises; ++k) {
+        if (c->pos_rules[k] >= c->nrules) return 0;
+    }
+    for (uint32_t r = 0; r < c->nrules; ++r) {
+        if (c->concl_rules[r] >= c->nrules) return 0;
+    }
+    // Bucket sizes: occurrences of each literal as a premise, then as a conclusion
+    uint32_t *count = (uint32_t*)calloc(nkeys ? nkeys : 1, sizeof(uint32_t));
+    int ok = 1;
+    for (uint32_t k = 0; k < c->npremises; ++k) count[c->premises[k]]++;
+    for (uint32_t v = 0; v < c->nsyms && ok; ++v) {
+        ok = count[LIT_MAKE(v, 0)] == c->pos_start[v + 1] - c->pos_start[v]
+          && count[LIT_MAKE(v, 1)] == c->neg_start[v + 1] - c->neg_start[v];
+    }
+    memset(count, 0, (nkeys ? nkeys : 1) * sizeof(uint32_t));
+    for (uint32_t r = 0; r < c->nrules; ++r) count[c->conclusions[r]]++;
+    for (size_t key = 0; key < nkeys && ok; ++key) {
+        ok = count[key] == c->concl_start[key + 1] - c->concl_start[key];
+    }
+    free(count);
+    return ok;
+}
+
+/**
+ * Construit une vue sur un bloc de stockage existant, sans copie.
+ * @param out Sortie: base compilée (storage NULL, ne pas libérer le bloc par elle).
+ * @param block Bloc au format de CompiledBC.storage (aligné sur 8 octets).
+ * @param size Taille du bloc en octets.
+ * @param nrules Nombre de règles.
+ * @param nsyms Nombre de symboles.
+ * @param npremises Nombre total de prémisses.
+ * @return 1 si le bloc est cohérent avec ces dimensions, 0 sinon.
+ */
+int compiled_view(CompiledBC *out, const void *block, size_t size,
+                  uint32_t nrules, uint32_t nsyms, uint32_t npremises) {
+    if (!out || !block || ((uintptr_t)block & 7)) return 0;
+    if (size != compiled_storage_size(nrules, nsyms, npremises)) return 0;
+    CompiledBC c;
+    memset(&c, 0, sizeof(c));
+    carve_layout(&c, (char*)block, nrules, nsyms, npremises);
+    // Offsets must stay inside their arrays before anything is indexed
+    if (c.pos_start[nsyms] > npremises) return 0;
+    c.neg_rules = c.pos_rules + c.pos_start[nsyms];
+    if (!layout_valid(&c)) return 0;
+    *out = c;
+    return 1;
+}
+
+/**
+ * Collecte les entrées d'une base compilée (prémisses jamais conclues).
+ * @param cbc Base compilée.
+ * @param out Sortie: identifiants triés par nom (à libérer avec free).
+ * @return Nombre d'entrées.
+ */
+size_t compiled_input_symbols(const CompiledBC *cbc, int **out) {
+    if (!out) return 0;
+    *out = NULL;
+    if (!cbc) return 0;
+    int *ids = (int*)malloc((cbc->nsyms ? cbc->nsyms : 1) * sizeof(int));
+    size_t n = 0;
+    for (uint32_t v = 0; v < cbc->nsyms; ++v) {
+        int used = cbc->pos_start[v + 1] > cbc->pos_start[v] || cbc->neg_start[v + 1] > cbc->neg_start[v];
+        uint32_t k = LIT_MAKE(v, 0);
+        int concluded = cbc->concl_start[k + 2] > cbc->concl_start[k];
+        if (used && !concluded) ids[n++] = (int)v;
+    }
+    if (n > 1) qsort(ids, n, sizeof(int), cmp_symbol_name);
+    *out = ids;
+    return n;
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <stdint.h>
+#include "bc.h"
+#include "stats.h"
+
+// Littéral compact: identifiant de symbole et négation dans un seul entier
+// (2*id + negated), aussi utilisé comme clé des plans de faits.
+#define LIT_MAKE(id, neg) (((uint32_t)(id) << 1) | ((neg) ? 1u : 0u))
+#define LIT_ID(l) ((int)((l) >> 1))
+#define LIT_NEG(l) ((int)((l) & 1u))
+
+// En-tête d'une règle compilée: ses prémisses occupent
+// premises[start .. start + npos + nneg), positives en tête.
+typedef struct CompiledRule {
+    uint32_t start;
+    uint32_t npos;
+    uint32_t nneg;
+} CompiledRule;
+
+// Base de connaissances compilée, immuable et contiguë (format CSR).
+// Seules les règles ayant une conclusion sont retenues, dans l'ordre de la
+// base. Tous les tableaux vivent dans un seul bloc mémoire.
+typedef struct CompiledBC {
+    uint32_t nrules;
+    uint32_t nsyms;              // symboles connus à la compilation
+    uint32_t npremises;
+    const CompiledRule *rules;   // nrules en-têtes
+    const uint32_t *premises;    // npremises littéraux
+    const uint32_t *conclusions; // nrules littéraux conclus
+    // Index inversés (CSR): symbole -> règles l'ayant en prémisse positive / négée
+    const uint32_t *pos_start;   // nsyms + 1
+    const uint32_t *pos_rules;
+    const uint32_t *neg_start;   // nsyms + 1
+    const uint32_t *neg_rules;
+    // Littéral conclu -> règles (CSR, clé 2*id + negated)
+    const uint32_t *concl_start; // 2 * nsyms + 1
+    const uint32_t *concl_rules;
+    void *storage;               // bloc possédé (NULL: vue sur une mémoire externe)
+    size_t storage_size;
+} CompiledBC;
+
+/**
+ * Compile une base de connaissances en représentation plate et immuable.
+ * La base source peut ensuite être modifiée sans affecter le résultat.
+ * @param bc Base de connaissances.
+ * @return Base compilée, à libérer avec compiled_free.
+ */
+CompiledBC bc_compile(const BC *bc);
+
+// Règle vue à plat, pour compiler une autre source que la BC chaînée.
+typedef struct RuleView {
+    const Proposition *premises;
+    uint32_t npremises;
+    Proposition conclusion;
+} RuleView;
+
+/**
+ * Compile un tableau de règles à plat (par exemple une version figée de la
+ * base, voir version.h), dans le même format que bc_compile. Ne lit pas la
+ * table des symboles: utilisable depuis n'importe quel thread.
+ * @param rules Règles (toutes avec conclusion), dans l'ordre de la base.
+ * @param nrules Nombre de règles.
+ * @param nsyms Nombre de symboles (tous les identifiants sont < nsyms).
+ * @return Base compilée, à libérer avec compiled_free.
+ */
+CompiledBC compiled_from_rules(const RuleView *rules, size_t nrules, size_t nsyms);
+
+/**
+ * Libère une base compilée.
+ * @param cbc Base compilée.
+ * @return Aucun.
+ */
+void compiled_free(CompiledBC *cbc);
+
+/**
+ * Taille du bloc de stockage d'une base compilée.
+ * @param nrules Nombre de règles.
+ * @param nsyms Nombre de symboles.
+ * @param npremises Nombre total de prémisses.
+ * @return Taille en octets.
+ */
+size_t compiled_storage_size(size_t nrules, size_t nsyms, size_t npremises);
+
+/**
+ * Construit une vue sur un bloc de stockage existant (ex: instantané
+ * projeté en mémoire), sans copie. Le bloc est vérifié en un passage
+ * linéaire (règles contiguës, littéraux et indices de règles dans les
+ * bornes, index inversés cohérents avec les règles) avant d'être adopté.
+ * @param out Sortie: base compilée (storage NULL: le bloc n'est pas possédé).
+ * @param block Bloc au format de CompiledBC.storage (aligné sur 8 octets).
+ * @param size Taille du bloc en octets.
+ * @param nrules Nombre de règles.
+ * @param nsyms Nombre de symboles.
+ * @param npremises Nombre total de prémisses.
+ * @return 1 si le bloc est cohérent, 0 sinon.
+ */
+int compiled_view(CompiledBC *out, const void *block, size_t size,
+                  uint32_t nrules, uint32_t nsyms, uint32_t npremises);
+
+/**
+ * Collecte les entrées d'une base compilée: symboles utilisés en prémisse
+ * sans être la conclusion d'aucune règle.
+ * @param cbc Base compilée.
+ * @param out Sortie: identifiants triés par nom (à libérer avec free).
+ * @return Nombre d'entrées.
+ */
+size_t compiled_input_symbols(const CompiledBC *cbc, int **out);
+
+/**
+ * Vérifie si la prémisse d'une règle compilée est satisfaite.
+ * Une prémisse ¬X est satisfaite si X est absent de la base de faits.
+ * Le plan doit couvrir les nsyms symboles de la base (voir facts_reserve).
+ * @param cbc Base compilée.
+ * @param r Indice de la règle.
+ * @param pos Plan des faits positifs (bits indexés par symbole).
+ * @return 1 si satisfaite, 0 sinon.
+ */
+static inline int compiled_rule_holds(const CompiledBC *cbc, uint32_t r, const uint64_t *pos) {
+    const CompiledRule *h = &cbc->rules[r];
+    const uint32_t *lit = cbc->premises + h->start;
+    for (uint32_t k = 0; k < h->npos; ++k) {
+        uint32_t id = lit[k] >> 1;
+        if (!((pos[id >> 6] >> (id & 63)) & 1u)) return 0;
+    }
+    for (uint32_t k = h->npos; k < h->npos + h->nneg; ++k) {
+        uint32_t id = lit[k] >> 1;
+        if ((pos[id >> 6] >> (id & 63)) & 1u) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Comme compiled_rule_holds, en comptant les littéraux testés.
+ * @param cbc Base compilée.
+ * @param r Indice de la règle.
+ * @param pos Plan des faits positifs.
+ * @param checks Compteur incrémenté d'un par littéral testé.
+ * @return 1 si satisfaite, 0 sinon.
+ */
+static inline int compiled_rule_holds_counted(const CompiledBC *cbc, uint32_t r, const uint64_t *pos, uint64_t *checks) {
+    const CompiledRule *h = &cbc->rules[r];
+    const uint32_t *lit = cbc->premises + h->start;
+    for (uint32_t k = 0; k < h->npos + h->nneg; ++k) {
+        uint32_t id = lit[k] >> 1;
+        ++*checks;
+        if ((int)((pos[id >> 6] >> (id & 63)) & 1u) != (k < h->npos)) return 0;
+    }
+    return 1;
+}
+
+// Test de règle des moteurs: compte les littéraux dans 'checks' seulement si
+// les statistiques sont compilées.
+#if SYS_EXPERT_STATS
+#define COMPILED_RULE_HOLDS(cbc, r, pos, checks) compiled_rule_holds_counted((cbc), (r), (pos), &(checks))
+#else
+#define COMPILED_RULE_HOLDS(cbc, r, pos, checks) compiled_rule_holds((cbc), (r), (pos))
+#endif
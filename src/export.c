@@ -0,0 +1,202 @@
+#include <stdlib.h>
+#include <string.h>
+#include "export.h"
+
+static const char *const FORMAT_NAMES[] = { "dot", "graphml" };
+
+// Output state shared by the BC and compiled walks
+typedef struct ExportWriter {
+    ExportFormat fmt;
+    const BaseFaits *facts;
+    FILE *out;
+    unsigned char *used;   // one bit per symbol seen in a rule
+    size_t nsyms;
+} ExportWriter;
+
+static void put_escaped(const ExportWriter *w, const char *s) {
+    for (; *s; ++s) {
+        const char *rep = NULL;
+        if (w->fmt == EXPORT_DOT) {
+            if (*s == '"') rep = "\\\"";
+            else if (*s == '\\') rep = "\\\\";
+        } else {
+            switch (*s) {
+            case '&': rep = "&amp;"; break;
+            case '<': rep = "&lt;"; break;
+            case '>': rep = "&gt;"; break;
+            case '"': rep = "&quot;"; break;
+            default: break;
+            }
+        }
+        if (rep) fputs(rep, w->out);
+        else putc(*s, w->out);
+    }
+}
+
+static void mark_used(ExportWriter *w, int id) {
+    if (id >= 0 && (size_t)id < w->nsyms) w->used[id >> 3] |= (unsigned char)(1u << (id & 7));
+}
+
+static void writer_begin(ExportWriter *w, ExportFormat fmt, const BaseFaits *facts, FILE *out) {
+    w->fmt = fmt;
+    w->facts = facts;
+    w->out = out;
+    w->nsyms = (size_t)symbol_count();
+    w->used = (unsigned char*)calloc(w->nsyms / 8 + 1, 1);
+    if (fmt == EXPORT_DOT) {
+        fputs("digraph bc {\n  rankdir=LR;\n", out);
+    } else {
+        fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+              "  <key id=\"kind\" for=\"node\" attr.name=\"kind\" attr.type=\"string\"/>\n"
+              "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n", out);
+        if (facts) fputs("  <key id=\"truth\" for=\"node\" attr.name=\"truth\" attr.type=\"string\"/>\n", out);
+        fputs("  <key id=\"negated\" for=\"edge\" attr.name=\"negated\" attr.type=\"boolean\">"
+              "<default>false</default></key>\n"
+              "  <graph id=\"bc\" edgedefault=\"directed\">\n", out);
+    }
+}
+
+static void write_rule(ExportWriter *w, size_t index) {
+    if (w->fmt == EXPORT_DOT) {
+        fprintf(w->out, "  r%zu [shape=box, label=\"#%zu\"];\n", index, index);
+    } else {
+        fprintf(w->out, "    <node id=\"r%zu\"><data key=\"kind\">rule</data>"
+                "<data key=\"label\">#%zu</data></node>\n", index, index);
+    }
+}
+
+static void write_premise(ExportWriter *w, size_t index, int id, int neg) {
+    mark_used(w, id);
+    if (w->fmt == EXPORT_DOT) {
+        fprintf(w->out, "  p%d -> r%zu%s;\n", id, index,
+                neg ? " [negated=true, style=dashed, arrowhead=odot]" : "");
+    } else if (neg) {
+        fprintf(w->out, "    <edge source=\"p%d\" target=\"r%zu\"><data key=\"negated\">true</data></edge>\n", id, index);
+    } else {
+        fprintf(w->out, "    <edge source=\"p%d\" target=\"r%zu\"/>\n", id, index);
+    }
+}
+
+static void write_conclusion(ExportWriter *w, size_t index, int id, int neg) {
+    mark_used(w, id);
+    if (w->fmt == EXPORT_DOT) {
+        fprintf(w->out, "  r%zu -> p%d%s;\n", index, id, neg ? " [negated=true, style=dashed]" : "");
+    } else if (neg) {
+        fprintf(w->out, "    <edge source=\"r%zu\" target=\"p%d\"><data key=\"negated\">true</data></edge>\n", index, id);
+    } else {
+        fprintf(w->out, "    <edge source=\"r%zu\" target=\"p%d\"/>\n", index, id);
+    }
+}
+
+// Proposition nodes come last: edges may name them before they are declared
+// in both formats, so the rules need a single pass.
+static int writer_end(ExportWriter *w) {
+    for (size_t id = 0; id < w->nsyms; ++id) {
+        if (!(w->used[id >> 3] & (1u << (id & 7)))) continue;
+        const char *truth = NULL;
+        if (w->facts) {
+            truth = facts_has(w->facts, (int)id, 0) ? "true"
+                  : facts_has(w->facts, (int)id, 1) ? "false" : "unknown";
+        }
+        if (w->fmt == EXPORT_DOT) {
+            fprintf(w->out, "  p%zu [label=\"", id);
+            put_escaped(w, symbol_name((int)id));
+            fputc('"', w->out);
+            if (truth) {
+                fprintf(w->out, ", truth=%s", truth);
+                if (truth[0] == 't') fputs(", style=filled, fillcolor=palegreen", w->out);
+                else if (truth[0] == 'f') fputs(", style=filled, fillcolor=lightpink", w->out);
+            }
+            fputs("];\n", w->out);
+        } else {
+            fprintf(w->out, "    <node id=\"p%zu\"><data key=\"kind\">proposition</data><data key=\"label\">", id);
+            put_escaped(w, symbol_name((int)id));
+            fputs("</data>", w->out);
+            if (truth) fprintf(w->out, "<data key=\"truth\">%s</data>", truth);
+            fputs("</node>\n", w->out);
+        }
+    }
+    fputs(w->fmt == EXPORT_DOT ? "}\n" : "  </graph>\n</graphml>\n", w->out);
+    free(w->used);
+    w->used = NULL;
+    return !ferror(w->out) && fflush(w->out) == 0;
+}
+
+/**
+ * Écrit le graphe d'une base de connaissances en flux.
+ * @param bc Base de connaissances.
+ * @param fmt Format de sortie.
+ * @param facts Base de faits optionnelle (attribut truth).
+ * @param out Flux de sortie.
+ * @return 1 si succès, 0 si erreur d'écriture.
+ */
+int export_bc(const BC *bc, ExportFormat fmt, const BaseFaits *facts, FILE *out) {
+    if (!bc || !out) return 0;
+    ExportWriter w;
+    writer_begin(&w, fmt, facts, out);
+    size_t index = 0;
+    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
+        const Regle *r = &rn->value;
+        write_rule(&w, ++index);
+        for (const ListPropositionNode *pn = r->premises.head; pn; pn = pn->next) {
+            if (pn->value.id != SYMBOL_NONE) write_premise(&w, index, pn->value.id, pn->value.negated);
+        }
+        if (regle_has_conclusion(r)) {
+            Proposition c = regle_get_conclusion(r);
+            write_conclusion(&w, index, c.id, c.negated);
+        }
+    }
+    return writer_end(&w);
+}
+
+/**
+ * Écrit le graphe d'une base compilée en flux.
+ * @param cbc Base compilée.
+ * @param fmt Format de sortie.
+ * @param facts Base de faits optionnelle (attribut truth).
+ * @param out Flux de sortie.
+ * @return 1 si succès, 0 si erreur d'écriture.
+ */
+int export_compiled(const CompiledBC *cbc, ExportFormat fmt, const BaseFaits *facts, FILE *out) {
+    if (!cbc || !out) return 0;
+    ExportWriter w;
+    writer_begin(&w, fmt, facts, out);
+    for (uint32_t r = 0; r < cbc->nrules; ++r) {
+        const CompiledRule *h = &cbc->rules[r];
+        write_rule(&w, (size_t)r + 1);
+        for (uint32_t k = 0; k < h->npos + h->nneg; ++k) {
+            uint32_t lit = cbc->premises[h->start + k];
+            write_premise(&w, (size_t)r + 1, LIT_ID(lit), LIT_NEG(lit));
+        }
+        write_conclusion(&w, (size_t)r + 1, LIT_ID(cbc->conclusions[r]), LIT_NEG(cbc->conclusions[r]));
+    }
+    return writer_end(&w);
+}
+
+/**
+ * Nom d'un format d'export.
+ * @param fmt Format.
+ * @return Nom court.
+ */
+const char *export_format_name(ExportFormat fmt) {
+    if ((int)fmt < 0 || (size_t)fmt >= sizeof(FORMAT_NAMES) / sizeof(FORMAT_NAMES[0])) return "?";
+    return FORMAT_NAMES[fmt];
+}
+
+/**
+ * Retrouve un format d'export par son nom.
+ * @param name Nom court.
+ * @param out Sortie: format correspondant.
+ * @return 1 si trouvé, 0 sinon.
+ */
+int export_format_from_name(const char *name, ExportFormat *out) {
+    if (!name) return 0;
+    for (size_t i = 0; i < sizeof(FORMAT_NAMES) / sizeof(FORMAT_NAMES[0]); ++i) {
+        if (strcmp(name, FORMAT_NAMES[i]) == 0) {
+            if (out) *out = (ExportFormat)i;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdio.h>
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+
+// Formats d'export du graphe des règles.
+typedef enum ExportFormat {
+    EXPORT_DOT = 0,   // Graphviz
+    EXPORT_GRAPHML    // GraphML (XML)
+} ExportFormat;
+
+/**
+ * Écrit le graphe d'une base de connaissances pour un outil de dessin
+ * externe, en flux: un seul parcours des règles, sans copie. Chaque règle
+ * devient un nœud "rN" (N: rang dans la base, à partir de 1) relié par des
+ * arcs prémisse -> règle et règle -> conclusion (attribut negated pour un
+ * littéral négé); chaque proposition devient un nœud "pID" (ID:
+ * identifiant de symbole), écrit après les règles. La seule mémoire
+ * annexe est un bit par symbole.
+ * @param bc Base de connaissances.
+ * @param fmt Format de sortie.
+ * @param facts Base de faits optionnelle: si non NULL, chaque proposition
+ *        porte un attribut truth (true, false ou unknown).
+ * @param out Flux de sortie.
+ * @return 1 si succès, 0 si erreur d'écriture.
+ */
+int export_bc(const BC *bc, ExportFormat fmt, const BaseFaits *facts, FILE *out);
+
+/**
+ * Écrit le graphe d'une base compilée (même format que export_bc; les
+ * règles sont numérotées dans l'ordre de la base compilée).
+ * @param cbc Base compilée.
+ * @param fmt Format de sortie.
+ * @param facts Base de faits optionnelle (attribut truth).
+ * @param out Flux de sortie.
+ * @return 1 si succès, 0 si erreur d'écriture.
+ */
+int export_compiled(const CompiledBC *cbc, ExportFormat fmt, const BaseFaits *facts, FILE *out);
+
+/**
+ * Nom d'un format d'export.
+ * @param fmt Format.
+ * @return "dot" ou "graphml".
+ */
+const char *export_format_name(ExportFormat fmt);
+
+/**
+ * Retrouve un format d'export par son nom.
+ * @param name "dot" ou "graphml".
+ * @param out Sortie: format correspondant.
+ * @return 1 si le nom est connu, 0 sinon.
+ */
+int export_format_from_name(const char *name, ExportFormat *out);
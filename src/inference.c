@@ -1,12 +1,35 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "inference.h"
+#include "stratify.h"
 
 /**
  * Crée une base de faits vide.
  * @return Base de faits initialisée.
  */
 BaseFaits facts_create() {
-    BaseFaits bf; bf.facts = listp_create(); return bf;
+    BaseFaits bf;
+    bf.pos = bf.neg = NULL;
+    bf.words = 0;
+    bf.order = NULL;
+    bf.where = NULL;
+    bf.order_len = bf.order_cap = 0;
+    bf.size = 0;
+    return bf;
+}
+
+/**
+ * Copie une base de faits (mêmes faits, même ordre d'insertion).
+ * @param bf Base de faits source.
+ * @return Nouvelle base de faits, à libérer avec facts_free.
+ */
+BaseFaits facts_copy(const BaseFaits *bf) {
+    BaseFaits out = facts_create();
+    size_t it = 0;
+    Proposition p;
+    while (facts_next(bf, &it, &p)) facts_add(&out, p);
+    return out;
 }
 
 /**
@@ -16,7 +39,43 @@ BaseFaits facts_create() {
  */
 void facts_free(BaseFaits *bf) {
     if (!bf) return;
-    listp_free(&bf->facts);
+    free(bf->pos);
+    free(bf->neg);
+    free(bf->order);
+    free(bf->where);
+    *bf = facts_create();
+}
+
+/**
+ * Réserve les plans de bits pour les symboles 0..nsyms-1, sans consulter la
+ * table des symboles.
+ * @param bf Base de faits.
+ * @param nsyms Nombre de symboles à rendre adressables.
+ * @return Aucun.
+ */
+void facts_reserve(BaseFaits *bf, size_t nsyms) {
+    size_t need = (nsyms + 63) >> 6;
+    if (!bf || need <= bf->words) return;
+    size_t words = bf->words ? bf->words : 1;
+    while (words < need) words *= 2;
+    bf->pos = (uint64_t*)realloc(bf->pos, words * sizeof(uint64_t));
+    bf->neg = (uint64_t*)realloc(bf->neg, words * sizeof(uint64_t));
+    memset(bf->pos + bf->words, 0, (words - bf->words) * sizeof(uint64_t));
+    memset(bf->neg + bf->words, 0, (words - bf->words) * sizeof(uint64_t));
+    bf->where = (uint32_t*)realloc(bf->where, words * 128 * sizeof(uint32_t));
+    bf->words = words;
+}
+
+// Drop tombstones from the insertion-order array, keeping order.
+static void facts_compact(BaseFaits *bf) {
+    size_t w = 0;
+    for (size_t r = 0; r < bf->order_len; ++r) {
+        const Proposition p = bf->order[r];
+        if (p.id == SYMBOL_NONE) continue;
+        bf->where[2 * (size_t)p.id + (size_t)p.negated] = (uint32_t)w;
+        bf->order[w++] = p;
+    }
+    bf->order_len = w;
 }
 
 /**
@@ -26,13 +85,83 @@ void facts_free(BaseFaits *bf) {
  * @return Aucun.
  */
 void facts_add(BaseFaits *bf, Proposition p) {
+    if (!bf || p.id == SYMBOL_NONE) return;
+    if (facts_has(bf, p.id, p.negated)) return;
+    facts_reserve(bf, (size_t)p.id + 1);
+    uint64_t *plane = p.negated ? bf->neg : bf->pos;
+    plane[(size_t)p.id >> 6] |= (uint64_t)1 << ((unsigned)p.id & 63);
+    if (bf->order_len == bf->order_cap) {
+        if (bf->order_len > 2 * bf->size) facts_compact(bf);
+        if (bf->order_len == bf->order_cap) {
+            bf->order_cap = bf->order_cap ? bf->order_cap * 2 : 16;
+            bf->order = (Proposition*)realloc(bf->order, bf->order_cap * sizeof(Proposition));
+        }
+    }
+    bf->where[2 * (size_t)p.id + (size_t)p.negated] = (uint32_t)bf->order_len;
+    bf->order[bf->order_len++] = p;
+    bf->size++;
+}
+
+/**
+ * Retire un fait de la base (O(1) amorti).
+ * @param bf Base de faits.
+ * @param p Proposition à retirer.
+ * @return 1 si retiré, 0 s'il était absent.
+ */
+int facts_remove(BaseFaits *bf, const Proposition *p) {
+    if (!bf || !p || !facts_has(bf, p->id, p->negated)) return 0;
+    uint64_t *plane = p->negated ? bf->neg : bf->pos;
+    plane[(size_t)p->id >> 6] &= ~((uint64_t)1 << ((unsigned)p->id & 63));
+    // Tombstone the entry; facts_add compacts once tombstones dominate
+    bf->order[bf->where[2 * (size_t)p->id + (size_t)p->negated]].id = SYMBOL_NONE;
+    bf->size--;
+    while (bf->order_len > 0 && bf->order[bf->order_len - 1].id == SYMBOL_NONE) bf->order_len--;
+    return 1;
+}
+
+/**
+ * Vide la base de faits sans libérer sa mémoire.
+ * @param bf Base de faits.
+ * @return Aucun.
+ */
+void facts_clear(BaseFaits *bf) {
     if (!bf) return;
-    if (!facts_contains(bf, &p)) {
-        listp_push_back(&bf->facts, p);
-    } else {
-        // Already present; free duplicate
-        proposition_free(&p);
+    for (size_t i = 0; i < bf->order_len; ++i) {
+        const Proposition *p = &bf->order[i];
+        if (p->id == SYMBOL_NONE) continue;
+        uint64_t *plane = p->negated ? bf->neg : bf->pos;
+        plane[(size_t)p->id >> 6] = 0;
+    }
+    bf->order_len = 0;
+    bf->size = 0;
+}
+
+/**
+ * Nombre de faits présents.
+ * @param bf Base de faits.
+ * @return Nombre de faits.
+ */
+size_t facts_size(const BaseFaits *bf) {
+    return bf ? bf->size : 0;
+}
+
+/**
+ * Parcourt les faits dans l'ordre d'insertion.
+ * @param bf Base de faits.
+ * @param cursor Curseur (initialisé à 0 par l'appelant).
+ * @param out Sortie: fait suivant.
+ * @return 1 si un fait a été produit, 0 en fin de parcours.
+ */
+int facts_next(const BaseFaits *bf, size_t *cursor, Proposition *out) {
+    if (!bf || !cursor) return 0;
+    while (*cursor < bf->order_len) {
+        const Proposition *p = &bf->order[(*cursor)++];
+        if (p->id != SYMBOL_NONE) {
+            if (out) *out = *p;
+            return 1;
+        }
     }
+    return 0;
 }
 
 /**
@@ -42,8 +171,8 @@ void facts_add(BaseFaits *bf, Proposition p) {
  * @return 1 si trouvé, 0 sinon.
  */
 int facts_contains(const BaseFaits *bf, const Proposition *p) {
-    if (!bf) return 0;
-    return listp_contains(&bf->facts, p);
+    if (!bf || !p) return 0;
+    return facts_has(bf, p->id, p->negated);
 }
 
 /**
@@ -52,49 +181,412 @@ int facts_contains(const BaseFaits *bf, const Proposition *p) {
  * @param bf Base de faits.
  * @return 1 si toutes les propositions de la prémisse sont présentes, 0 sinon.
  */
-static int premises_satisfied(const Regle *r, const BaseFaits *bf) {
+int inference_premises_satisfied(const Regle *r, const BaseFaits *bf) {
     const ListPropositionNode *cur = r->premises.head;
     while (cur) {
         const Proposition *p = &cur->value;
-        if (!p->negated) {
-            if (!facts_contains(bf, p)) return 0;
-        } else {
-            // Negated premise: satisfied if the positive counterpart is NOT present
-            Proposition pos = proposition_make(p->name, 0);
-            int pos_present = facts_contains(bf, &pos);
-            proposition_free(&pos);
-            if (pos_present) return 0;
-        }
+        // Negated premise: satisfied if the positive counterpart is NOT present
+        if (facts_has(bf, p->id, 0) == p->negated) return 0;
         cur = cur->next;
     }
     return 1;
 }
 
+#if SYS_EXPERT_STATS
+// inference_premises_satisfied, counting the tested premises. Positive
+// premises go first, as in the compiled layout, so every engine stops at
+// the same literal.
+static int premises_satisfied_counted(const Regle *r, const BaseFaits *bf, uint64_t *checks) {
+    for (int negated = 0; negated < 2; ++negated) {
+        for (const ListPropositionNode *cur = r->premises.head; cur; cur = cur->next) {
+            if (cur->value.negated != negated) continue;
+            ++*checks;
+            if (facts_has(bf, cur->value.id, 0) == negated) return 0;
+        }
+    }
+    return 1;
+}
+#define PREMISES_SATISFIED(r, bf, checks) premises_satisfied_counted((r), (bf), &(checks))
+#else
+#define PREMISES_SATISFIED(r, bf, checks) inference_premises_satisfied((r), (bf))
+#endif
+
 /**
- * Moteur d'inférence par chaînage avant.
- * Ajoute des conclusions à la base de faits tant qu'il y a des changements.
+ * Moteur d'inférence par chaînage avant, avec statistiques et justifications.
  * @param bc Base de connaissances.
  * @param bf Base de faits (modifiée en place).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications des faits déduits (NULL: aucune).
  * @return Aucun.
  */
-void inference_forward_chain(const BC *bc, BaseFaits *bf) {
+void inference_forward_chain_stats(const BC *bc, BaseFaits *bf, InferenceStats *stats, Justification *just) {
     if (!bc || !bf) return;
+    (void)stats; // unread when SYS_EXPERT_STATS is 0
+    STATS_ONLY(InferenceStats n; memset(&n, 0, sizeof(n)); double t0 = stats ? stats_now() : 0;)
+    uint32_t pass = 0;
     int changed;
     do {
         changed = 0;
+        pass++;
+        STATS_ONLY(n.passes++;)
+        // Rules with a conclusion are numbered like their compiled form
+        uint32_t index = 0;
         const ListRegleNode *cur = bc->regles.head;
         while (cur) {
             const Regle *r = &cur->value;
-            if (regle_has_conclusion(r) && premises_satisfied(r, bf)) {
+            STATS_ONLY(n.rule_evaluations++;)
+            // A rule whose conclusion is known has nothing left to add
+            if (regle_has_conclusion(r) && !facts_has(bf, r->conclusion.id, r->conclusion.negated) &&
+                PREMISES_SATISFIED(r, bf, n.premise_checks)) {
                 Proposition c = regle_get_conclusion(r);
-                if (!facts_contains(bf, &c)) {
-                    // copy to avoid freeing original from rule
-                    Proposition nc = proposition_make(c.name, c.negated);
-                    facts_add(bf, nc);
-                    changed = 1;
-                }
+                facts_add(bf, c);
+                if (just) justification_record(just, LIT_MAKE(c.id, c.negated), index, pass);
+                STATS_ONLY(n.rules_fired++; n.facts_derived++;)
+                changed = 1;
             }
+            if (regle_has_conclusion(r)) index++;
             cur = cur->next;
         }
     } while (changed);
+    STATS_ONLY(stats_merge(stats, &n); stats_add_time(stats, STATS_PHASE_INFER, t0);)
+}
+
+/**
+ * Moteur d'inférence par chaînage avant.
+ * Ajoute des conclusions à la base de faits tant qu'il y a des changements.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain(const BC *bc, BaseFaits *bf) {
+    inference_forward_chain_stats(bc, bf, NULL, NULL);
+}
+
+/**
+ * Chaînage avant naïf sur une base compilée, avec statistiques et justifications.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications des faits déduits (NULL: aucune).
+ * @return Aucun.
+ */
+void inference_forward_chain_compiled_stats(const CompiledBC *cbc, BaseFaits *bf, InferenceStats *stats, Justification *just) {
+    if (!cbc || !bf) return;
+    facts_reserve(bf, cbc->nsyms);
+    (void)stats; // unread when SYS_EXPERT_STATS is 0
+    STATS_ONLY(InferenceStats n; memset(&n, 0, sizeof(n)); double t0 = stats ? stats_now() : 0;)
+    uint32_t pass = 0;
+    int changed;
+    do {
+        changed = 0;
+        pass++;
+        STATS_ONLY(n.passes++;)
+        for (uint32_t r = 0; r < cbc->nrules; ++r) {
+            uint32_t c = cbc->conclusions[r];
+            STATS_ONLY(n.rule_evaluations++;)
+            if (facts_has(bf, LIT_ID(c), LIT_NEG(c))) continue;
+            if (COMPILED_RULE_HOLDS(cbc, r, bf->pos, n.premise_checks)) {
+                facts_add(bf, proposition_from_id(LIT_ID(c), LIT_NEG(c)));
+                if (just) justification_record(just, c, r, pass);
+                STATS_ONLY(n.rules_fired++; n.facts_derived++;)
+                changed = 1;
+            }
+        }
+    } while (changed);
+    STATS_ONLY(stats_merge(stats, &n); stats_add_time(stats, STATS_PHASE_INFER, t0);)
+}
+
+/**
+ * Chaînage avant naïf sur une base compilée.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain_compiled(const CompiledBC *cbc, BaseFaits *bf) {
+    inference_forward_chain_compiled_stats(cbc, bf, NULL, NULL);
+}
+
+/**
+ * Crée l'état de travail du moteur agenda pour une base compilée.
+ * @param cbc Base compilée.
+ * @return État de travail, à libérer avec agenda_scratch_free.
+ */
+AgendaScratch agenda_scratch_create(const CompiledBC *cbc) {
+    AgendaScratch sc;
+    size_t nrules = cbc && cbc->nrules ? cbc->nrules : 1;
+    size_t nsyms = cbc && cbc->nsyms ? cbc->nsyms : 1;
+    sc.unsat = (uint32_t*)malloc(nrules * sizeof(uint32_t));
+    sc.queue = (uint32_t*)malloc(nsyms * sizeof(uint32_t));
+    sc.deferred = (uint32_t*)malloc(nrules * sizeof(uint32_t));
+    sc.stratum = (uint32_t*)malloc(nrules * sizeof(uint32_t));
+    // The strata give every rule its slot range in 'deferred'; a base with a
+    // negative cycle still gets its components in topological order
+    Strata st;
+    inference_stratify(cbc, &st);
+    sc.nstrata = st.count;
+    sc.dstart = (size_t*)malloc((st.count + 1) * sizeof(size_t));
+    sc.dtail = (size_t*)malloc((st.count ? st.count : 1) * sizeof(size_t));
+    sc.dstart[0] = 0;
+    if (st.start) memcpy(sc.dstart, st.start, (st.count + 1) * sizeof(size_t));
+    for (size_t s = 0; s < st.count; ++s) {
+        for (size_t k = st.start[s]; k < st.start[s + 1]; ++k) sc.stratum[st.rules[k]] = (uint32_t)s;
+    }
+    strata_free(&st);
+    return sc;
+}
+
+/**
+ * Libère l'état de travail du moteur agenda.
+ * @param sc État de travail.
+ * @return Aucun.
+ */
+void agenda_scratch_free(AgendaScratch *sc) {
+    if (!sc) return;
+    free(sc->unsat);
+    free(sc->queue);
+    free(sc->deferred);
+    free(sc->stratum);
+    free(sc->dstart);
+    free(sc->dtail);
+    sc->unsat = sc->queue = sc->deferred = sc->stratum = NULL;
+    sc->dstart = sc->dtail = NULL;
+    sc->nstrata = 0;
+}
+
+// The agenda has no passes: a fact's "pass" is its derivation depth, one
+// more than the deepest positive premise (initial facts are at depth 0).
+static uint32_t agenda_depth(const CompiledBC *cbc, uint32_t r, const Justification *just) {
+    const CompiledRule *h = &cbc->rules[r];
+    uint32_t depth = 0;
+    for (uint32_t k = 0; k < h->npos; ++k) {
+        uint32_t key = cbc->premises[h->start + k];
+        if (key < just->nkeys && just->entries[key].pass > depth) depth = just->entries[key].pass;
+    }
+    return depth + 1;
+}
+
+/**
+ * Moteur d'inférence par agenda, avec statistiques et justifications.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param sc État de travail créé pour cbc (NULL: créé pour l'appel).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications des faits déduits (NULL: aucune).
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda_stats(const CompiledBC *cbc, BaseFaits *bf, AgendaScratch *sc,
+                                          InferenceStats *stats, Justification *just) {
+    if (!cbc || !bf || cbc->nrules == 0) return;
+    if (!sc) {
+        STATS_ONLY(double tp = stats ? stats_now() : 0;)
+        AgendaScratch own = agenda_scratch_create(cbc);
+        STATS_ONLY(stats_add_time(stats, STATS_PHASE_PREPARE, tp);)
+        inference_forward_chain_agenda_stats(cbc, bf, &own, stats, just);
+        agenda_scratch_free(&own);
+        return;
+    }
+    facts_reserve(bf, cbc->nsyms);
+    (void)stats; // unread when SYS_EXPERT_STATS is 0
+    STATS_ONLY(InferenceStats n; memset(&n, 0, sizeof(n)); double t0 = stats ? stats_now() : 0;)
+    uint32_t nrules = cbc->nrules;
+    // Per-rule count of positive premises still missing
+    uint32_t *unsat = sc->unsat;
+    for (uint32_t r = 0; r < nrules; ++r) unsat[r] = cbc->rules[r].npos;
+    // Work queue of positive facts whose consequences are not yet propagated.
+    // Each symbol enters at most once, so nsyms slots are enough.
+    uint32_t *queue = sc->queue;
+    size_t qhead = 0, qtail = 0;
+    // Ready rules carrying negated premises wait until positive propagation
+    // is exhausted, then run one stratum at a time in topological order: a
+    // rule deriving X sits in an earlier stratum than any rule reading ¬X,
+    // so ¬X is only checked once X can no longer appear (as in the
+    // stratified engine). Facts derived from stratum s only feed strata >= s,
+    // so the cursor never moves back.
+    uint32_t *deferred = sc->deferred;
+    size_t *dtail = sc->dtail;
+    for (size_t s = 0; s < sc->nstrata; ++s) dtail[s] = sc->dstart[s];
+    size_t cur = 0, dhead = sc->dstart[0];
+
+    size_t it = 0;
+    Proposition f;
+    while (facts_next(bf, &it, &f)) {
+        if (!f.negated && (uint32_t)f.id < cbc->nsyms) queue[qtail++] = (uint32_t)f.id;
+    }
+
+#define AGENDA_FIRE(ri) do { \
+        uint32_t c_ = cbc->conclusions[(ri)]; \
+        if (facts_has(bf, LIT_ID(c_), LIT_NEG(c_))) break; \
+        facts_add(bf, proposition_from_id(LIT_ID(c_), LIT_NEG(c_))); \
+        if (just) justification_record(just, c_, (ri), agenda_depth(cbc, (ri), just)); \
+        STATS_ONLY(n.rules_fired++; n.facts_derived++;) \
+        if (!LIT_NEG(c_)) queue[qtail++] = c_ >> 1; \
+    } while (0)
+
+    for (uint32_t r = 0; r < nrules; ++r) {
+        if (unsat[r] != 0) continue;
+        STATS_ONLY(n.rule_evaluations++;)
+        if (cbc->rules[r].nneg) deferred[dtail[sc->stratum[r]]++] = r; else AGENDA_FIRE(r);
+    }
+
+    while (1) {
+        while (qhead < qtail) {
+            uint32_t id = queue[qhead++];
+            for (uint32_t k = cbc->pos_start[id]; k < cbc->pos_start[id + 1]; ++k) {
+                uint32_t ri = cbc->pos_rules[k];
+                STATS_ONLY(n.premise_checks++;)
+                if (--unsat[ri] != 0) continue;
+                STATS_ONLY(n.rule_evaluations++;)
+                if (cbc->rules[ri].nneg) deferred[dtail[sc->stratum[ri]]++] = ri; else AGENDA_FIRE(ri);
+            }
+        }
+        while (cur < sc->nstrata && dhead == dtail[cur]) {
+            if (++cur < sc->nstrata) dhead = sc->dstart[cur];
+        }
+        if (cur == sc->nstrata) break;
+        // Facts only grow, so a rule blocked by ¬X now stays blocked.
+        uint32_t ri = deferred[dhead++];
+        uint32_t c = cbc->conclusions[ri];
+        if (facts_has(bf, LIT_ID(c), LIT_NEG(c))) continue;
+        if (COMPILED_RULE_HOLDS(cbc, ri, bf->pos, n.premise_checks)) AGENDA_FIRE(ri);
+    }
+#undef AGENDA_FIRE
+    STATS_ONLY(stats_merge(stats, &n); stats_add_time(stats, STATS_PHASE_INFER, t0);)
+}
+
+/**
+ * Moteur d'inférence par agenda avec un état de travail fourni.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param sc État de travail créé pour cbc.
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda_scratch(const CompiledBC *cbc, BaseFaits *bf, AgendaScratch *sc) {
+    if (!sc) return;
+    inference_forward_chain_agenda_stats(cbc, bf, sc, NULL, NULL);
+}
+
+/**
+ * Moteur d'inférence par agenda sur une base compilée.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda_compiled(const CompiledBC *cbc, BaseFaits *bf) {
+    inference_forward_chain_agenda_stats(cbc, bf, NULL, NULL, NULL);
+}
+
+/**
+ * Moteur d'inférence par agenda (compteurs de prémisses, type RETE simplifié).
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda(const BC *bc, BaseFaits *bf) {
+    if (!bc || !bf) return;
+    CompiledBC cbc = bc_compile(bc);
+    inference_forward_chain_agenda_compiled(&cbc, bf);
+    compiled_free(&cbc);
+}
+
+/**
+ * Lance le moteur d'inférence choisi sur une base compilée, avec statistiques et justifications.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications des faits déduits (NULL: aucune).
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run_compiled_stats(const CompiledBC *cbc, BaseFaits *bf, InferenceEngine engine,
+                                 InferenceStats *stats, Justification *just) {
+    switch (engine) {
+    case ENGINE_AGENDA: inference_forward_chain_agenda_stats(cbc, bf, NULL, stats, just); return 1;
+    case ENGINE_STRATIFIED: {
+        if (!cbc || !bf) return 0;
+        STATS_ONLY(double tp = stats ? stats_now() : 0;)
+        Strata st;
+        int ok = inference_stratify(cbc, &st);
+        STATS_ONLY(stats_add_time(stats, STATS_PHASE_PREPARE, tp);)
+        ok = ok && strata_forward_chain_stats(cbc, &st, bf, stats, just);
+        strata_free(&st);
+        return ok;
+    }
+    case ENGINE_NAIVE:
+    default: inference_forward_chain_compiled_stats(cbc, bf, stats, just); return 1;
+    }
+}
+
+/**
+ * Lance le moteur d'inférence choisi sur une base compilée.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run_compiled(const CompiledBC *cbc, BaseFaits *bf, InferenceEngine engine) {
+    return inference_run_compiled_stats(cbc, bf, engine, NULL, NULL);
+}
+
+/**
+ * Lance le moteur d'inférence choisi, avec statistiques et justifications.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications des faits déduits (NULL: aucune).
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run_stats(const BC *bc, BaseFaits *bf, InferenceEngine engine, InferenceStats *stats, Justification *just) {
+    if (!bc || !bf) return 0;
+    // The naive engine stays on the linked lists as the reference
+    if (engine == ENGINE_NAIVE) {
+        inference_forward_chain_stats(bc, bf, stats, just);
+        return 1;
+    }
+    STATS_ONLY(double tc = stats ? stats_now() : 0;)
+    CompiledBC cbc = bc_compile(bc);
+    STATS_ONLY(stats_add_time(stats, STATS_PHASE_COMPILE, tc);)
+    int ok = inference_run_compiled_stats(&cbc, bf, engine, stats, just);
+    compiled_free(&cbc);
+    return ok;
+}
+
+/**
+ * Lance le moteur d'inférence choisi.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run(const BC *bc, BaseFaits *bf, InferenceEngine engine) {
+    return inference_run_stats(bc, bf, engine, NULL, NULL);
+}
+
+static const char *const ENGINE_NAMES[] = { "naive", "agenda", "stratified" };
+
+/**
+ * Nom d'un moteur d'inférence.
+ * @param engine Moteur.
+ * @return Nom court ("naive", "agenda", ...).
+ */
+const char *inference_engine_name(InferenceEngine engine) {
+    if ((int)engine < 0 || (size_t)engine >= sizeof(ENGINE_NAMES) / sizeof(ENGINE_NAMES[0])) return "?";
+    return ENGINE_NAMES[engine];
+}
+
+/**
+ * Retrouve un moteur d'inférence par son nom.
+ * @param name Nom court du moteur.
+ * @param out Sortie: moteur correspondant.
+ * @return 1 si trouvé, 0 sinon.
+ */
+int inference_engine_from_name(const char *name, InferenceEngine *out) {
+    if (!name) return 0;
+    for (size_t i = 0; i < sizeof(ENGINE_NAMES) / sizeof(ENGINE_NAMES[0]); ++i) {
+        if (strcmp(name, ENGINE_NAMES[i]) == 0) {
+            if (out) *out = (InferenceEngine)i;
+            return 1;
+        }
+    }
+    return 0;
 }
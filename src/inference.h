@@ -1,17 +1,51 @@
 #pragma once
+#include <stdint.h>
 #include "bc.h"
+#include "compiled.h"
+#include "justification.h"
 #include "list_proposition.h"
+#include "stats.h"
 
+// Base de faits: deux plans de bits indexés par identifiant de symbole
+// (faits positifs et faits négés ¬) pour des tests en O(1), plus la liste
+// des faits dans l'ordre d'insertion pour l'affichage.
 typedef struct BaseFaits {
-    ListProposition facts;
+    uint64_t *pos;       // bit i: fait i présent
+    uint64_t *neg;       // bit i: fait ¬i présent
+    size_t words;        // nombre de mots alloués par plan
+    Proposition *order;  // faits dans l'ordre d'insertion (id SYMBOL_NONE: retiré)
+    uint32_t *where;     // 2*id + negated -> position dans order (si présent)
+    size_t order_len;    // nombre d'entrées utilisées dans order
+    size_t order_cap;
+    size_t size;         // nombre de faits présents
 } BaseFaits;
 
+/**
+ * Teste la présence d'un fait par identifiant de symbole (O(1)).
+ * @param bf Base de faits.
+ * @param id Identifiant du symbole.
+ * @param negated 1 pour tester ¬id, 0 sinon.
+ * @return 1 si présent, 0 sinon.
+ */
+static inline int facts_has(const BaseFaits *bf, int id, int negated) {
+    if (id < 0 || (size_t)id >= bf->words * 64) return 0;
+    const uint64_t *plane = negated ? bf->neg : bf->pos;
+    return (int)((plane[(size_t)id >> 6] >> ((unsigned)id & 63)) & 1u);
+}
+
 /**
  * Crée une base de faits vide.
  * @return Base de faits initialisée.
  */
 BaseFaits facts_create();
 
+/**
+ * Copie une base de faits (mêmes faits, même ordre d'insertion).
+ * @param bf Base de faits source.
+ * @return Nouvelle base de faits, à libérer avec facts_free.
+ */
+BaseFaits facts_copy(const BaseFaits *bf);
+
 /**
  * Libère la base de faits.
  * @param bf Pointeur vers la base de faits.
@@ -27,6 +61,48 @@ void facts_free(BaseFaits *bf);
  */
 void facts_add(BaseFaits *bf, Proposition p);
 
+/**
+ * Réserve les plans de bits pour les symboles 0..nsyms-1, sans consulter la
+ * table des symboles.
+ * @param bf Base de faits.
+ * @param nsyms Nombre de symboles à rendre adressables.
+ * @return Aucun.
+ */
+void facts_reserve(BaseFaits *bf, size_t nsyms);
+
+/**
+ * Retire un fait de la base (O(1) amorti).
+ * @param bf Base de faits.
+ * @param p Proposition à retirer.
+ * @return 1 si retiré, 0 s'il était absent.
+ */
+int facts_remove(BaseFaits *bf, const Proposition *p);
+
+/**
+ * Vide la base de faits sans libérer sa mémoire
+ * (coût proportionnel au nombre de faits, pas au nombre de symboles).
+ * @param bf Base de faits.
+ * @return Aucun.
+ */
+void facts_clear(BaseFaits *bf);
+
+/**
+ * Nombre de faits présents.
+ * @param bf Base de faits.
+ * @return Nombre de faits.
+ */
+size_t facts_size(const BaseFaits *bf);
+
+/**
+ * Parcourt les faits dans l'ordre d'insertion.
+ * Usage: size_t it = 0; Proposition p; while (facts_next(bf, &it, &p)) { ... }
+ * @param bf Base de faits.
+ * @param cursor Curseur (initialisé à 0 par l'appelant).
+ * @param out Sortie: fait suivant.
+ * @return 1 si un fait a été produit, 0 en fin de parcours.
+ */
+int facts_next(const BaseFaits *bf, size_t *cursor, Proposition *out);
+
 /**
  * Teste si un fait appartient à la base.
  * @param bf Base de faits.
@@ -35,6 +111,15 @@ void facts_add(BaseFaits *bf, Proposition p);
  */
 int facts_contains(const BaseFaits *bf, const Proposition *p);
 
+/**
+ * Vérifie si la prémisse d'une règle est satisfaite par la base de faits.
+ * Une prémisse ¬X est satisfaite si X est absent de la base.
+ * @param r Règle cible.
+ * @param bf Base de faits.
+ * @return 1 si toutes les propositions de la prémisse sont satisfaites, 0 sinon.
+ */
+int inference_premises_satisfied(const Regle *r, const BaseFaits *bf);
+
 /**
  * Moteur d'inférence par chaînage avant.
  * Ajoute des conclusions à la base de faits tant qu'il y a des changements.
@@ -43,3 +128,180 @@ int facts_contains(const BaseFaits *bf, const Proposition *p);
  * @return Aucun.
  */
 void inference_forward_chain(const BC *bc, BaseFaits *bf);
+
+/**
+ * Comme inference_forward_chain, en cumulant les statistiques dans stats
+ * (passes, règles évaluées, prémisses testées, règles déclenchées, faits
+ * déduits, temps d'inférence). Sans SYS_EXPERT_STATS, stats reste inchangé.
+ * Avec just, chaque fait déduit note sa règle (indice parmi les règles ayant
+ * une conclusion, comme dans bc_compile) et sa passe.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications, créées pour symbol_count() symboles (NULL: aucune).
+ * @return Aucun.
+ */
+void inference_forward_chain_stats(const BC *bc, BaseFaits *bf, InferenceStats *stats, Justification *just);
+
+// Moteurs d'inférence disponibles.
+typedef enum InferenceEngine {
+    ENGINE_NAIVE = 0,  // passes répétées sur toutes les règles (référence)
+    ENGINE_AGENDA,     // compteurs de prémisses + file de travail
+    ENGINE_STRATIFIED  // strates (composantes fortement connexes) en ordre topologique
+} InferenceEngine;
+
+/**
+ * Moteur d'inférence par agenda (compteurs de prémisses, type RETE simplifié).
+ * Un index inversé associe chaque proposition aux règles qui l'utilisent
+ * en prémisse positive; chaque règle garde le nombre de prémisses positives
+ * non satisfaites et se déclenche dès que ce compteur atteint zéro. Chaque
+ * fait dérivé ne touche que les règles qui le référencent.
+ * Les prémisses négées (¬X) sont vérifiées au moment du déclenchement, après
+ * épuisement de la propagation positive.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda(const BC *bc, BaseFaits *bf);
+
+/**
+ * Chaînage avant naïf sur une base compilée (mêmes passes que
+ * inference_forward_chain, sans parcours de listes chaînées).
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain_compiled(const CompiledBC *cbc, BaseFaits *bf);
+
+/**
+ * Chaînage avant naïf sur une base compilée, avec statistiques et
+ * justifications.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications, créées pour cbc->nsyms symboles (NULL: aucune).
+ * @return Aucun.
+ */
+void inference_forward_chain_compiled_stats(const CompiledBC *cbc, BaseFaits *bf, InferenceStats *stats, Justification *just);
+
+/**
+ * Moteur d'inférence par agenda sur une base compilée.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda_compiled(const CompiledBC *cbc, BaseFaits *bf);
+
+// État de travail du moteur agenda, réutilisable d'un appel à l'autre sur la
+// même base compilée (un par thread en cas d'exécution parallèle).
+typedef struct AgendaScratch {
+    uint32_t *unsat;     // règle -> prémisses positives manquantes
+    uint32_t *queue;     // faits positifs à propager
+    uint32_t *deferred;  // règles prêtes portant des prémisses négées, par strate
+    uint32_t *stratum;   // règle -> strate de sa conclusion (ordre topologique)
+    size_t *dstart;      // strate -> début de ses règles dans deferred
+    size_t *dtail;       // strate -> fin de ses règles prêtes dans deferred
+    size_t nstrata;
+} AgendaScratch;
+
+/**
+ * Crée l'état de travail du moteur agenda pour une base compilée (calcule
+ * les strates: les règles à prémisses négées sont évaluées strate par strate).
+ * @param cbc Base compilée.
+ * @return État de travail, à libérer avec agenda_scratch_free.
+ */
+AgendaScratch agenda_scratch_create(const CompiledBC *cbc);
+
+/**
+ * Libère l'état de travail du moteur agenda.
+ * @param sc État de travail.
+ * @return Aucun.
+ */
+void agenda_scratch_free(AgendaScratch *sc);
+
+/**
+ * Moteur d'inférence par agenda avec un état de travail fourni (aucune
+ * allocation hors extension de la base de faits).
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param sc État de travail créé pour cbc.
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda_scratch(const CompiledBC *cbc, BaseFaits *bf, AgendaScratch *sc);
+
+/**
+ * Moteur d'inférence par agenda, avec statistiques. Sans boucle de passes,
+ * l'agenda compte une évaluation par règle devenue prête et un test de
+ * prémisse par décrément de compteur ou littéral vérifié au déclenchement.
+ * La "passe" d'une justification y est la profondeur de dérivation (1 + la
+ * plus grande des prémisses positives, 0 pour un fait initial).
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param sc État de travail créé pour cbc (NULL: créé pour l'appel, temps
+ *           compté dans la phase de préparation).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications, créées pour cbc->nsyms symboles (NULL: aucune).
+ * @return Aucun.
+ */
+void inference_forward_chain_agenda_stats(const CompiledBC *cbc, BaseFaits *bf, AgendaScratch *sc,
+                                          InferenceStats *stats, Justification *just);
+
+/**
+ * Lance le moteur d'inférence choisi sur une base compilée.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run_compiled(const CompiledBC *cbc, BaseFaits *bf, InferenceEngine engine);
+
+/**
+ * Lance le moteur choisi sur une base compilée, avec statistiques (le calcul
+ * des strates compte dans la phase de préparation) et justifications.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications, créées pour cbc->nsyms symboles (NULL: aucune).
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run_compiled_stats(const CompiledBC *cbc, BaseFaits *bf, InferenceEngine engine,
+                                 InferenceStats *stats, Justification *just);
+
+/**
+ * Lance le moteur d'inférence choisi.
+ * Les moteurs autres que naive compilent la base (bc_compile) avant de tourner.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @return 1 si succès, 0 si le moteur a rejeté la base (ex: base non stratifiable).
+ */
+int inference_run(const BC *bc, BaseFaits *bf, InferenceEngine engine);
+
+/**
+ * Lance le moteur choisi, avec statistiques (bc_compile compte dans la phase
+ * de compilation) et justifications. Les indices de règles des
+ * justifications sont ceux de bc_compile(bc), quel que soit le moteur.
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @param engine Moteur à utiliser.
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications, créées pour symbol_count() symboles (NULL: aucune).
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_run_stats(const BC *bc, BaseFaits *bf, InferenceEngine engine, InferenceStats *stats, Justification *just);
+
+/**
+ * Nom d'un moteur d'inférence.
+ * @param engine Moteur.
+ * @return Nom court ("naive", "agenda", ...).
+ */
+const char *inference_engine_name(InferenceEngine engine);
+
+/**
+ * Retrouve un moteur d'inférence par son nom.
+ * @param name Nom court du moteur.
+ * @param out Sortie: moteur correspondant.
+ * @return 1 si trouvé, 0 sinon.
+ */
+int inference_engine_from_name(const char *name, InferenceEngine *out);
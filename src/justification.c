@@ -0,0 +1,171 @@
+#include <stdlib.h>
+#include <string.h>
+#include "inference.h"
+#include "justification.h"
+
+/**
+ * Crée un enregistrement vide pour les symboles 0..nsyms-1.
+ * @param nsyms Nombre de symboles.
+ * @return Enregistrement, à libérer avec justification_free.
+ */
+Justification justification_create(size_t nsyms) {
+    Justification j;
+    j.nkeys = 2 * nsyms;
+    j.entries = (JustificationEntry*)calloc(j.nkeys ? j.nkeys : 1, sizeof(JustificationEntry));
+    return j;
+}
+
+/**
+ * Libère un enregistrement.
+ * @param j Enregistrement.
+ * @return Aucun.
+ */
+void justification_free(Justification *j) {
+    if (!j) return;
+    free(j->entries);
+    j->entries = NULL;
+    j->nkeys = 0;
+}
+
+/**
+ * Oublie toutes les déductions enregistrées.
+ * @param j Enregistrement.
+ * @return Aucun.
+ */
+void justification_clear(Justification *j) {
+    if (!j || !j->entries) return;
+    memset(j->entries, 0, j->nkeys * sizeof(JustificationEntry));
+}
+
+/**
+ * Donne la justification d'un fait.
+ * @param j Enregistrement.
+ * @param p Fait.
+ * @param rule Sortie optionnelle: indice de la règle compilée.
+ * @param pass Sortie optionnelle: passe de déclenchement.
+ * @return 1 si le fait a été déduit, 0 sinon.
+ */
+int justification_get(const Justification *j, Proposition p, uint32_t *rule, uint32_t *pass) {
+    if (!j || p.id < 0) return 0;
+    uint32_t key = LIT_MAKE(p.id, p.negated);
+    if (key >= j->nkeys || j->entries[key].rule == 0) return 0;
+    if (rule) *rule = j->entries[key].rule - 1;
+    if (pass) *pass = j->entries[key].pass;
+    return 1;
+}
+
+static void print_literal(uint32_t lit, FILE *out) {
+    fprintf(out, "%s%s", LIT_NEG(lit) ? "¬" : "", symbol_name(LIT_ID(lit)));
+}
+
+static void print_rule(const CompiledBC *cbc, uint32_t r, FILE *out) {
+    const CompiledRule *h = &cbc->rules[r];
+    for (uint32_t k = 0; k < h->npos + h->nneg; ++k) {
+        if (k) fputs(" & ", out);
+        print_literal(cbc->premises[h->start + k], out);
+    }
+    fputs(h->npos + h->nneg ? " => " : "=> ", out);
+    print_literal(cbc->conclusions[r], out);
+}
+
+// One node being expanded: its key and the next premise to print
+typedef struct ProofFrame {
+    uint32_t key;
+    uint32_t next;
+    size_t prefix_len;   // prefix length for its children
+} ProofFrame;
+
+// Prints the label of 'key' as a premise or root; returns 1 if it has
+// children to expand.
+static int print_node(const Justification *j, const CompiledBC *cbc, const BaseFaits *bf,
+                      uint32_t key, int as_premise, unsigned char *seen, FILE *out) {
+    int id = LIT_ID(key);
+    if (as_premise && LIT_NEG(key)) {
+        // Negation as failure: ¬X holds because X is absent
+        fprintf(out, "¬%s  (%s absent%s)\n", symbol_name(id), symbol_name(id),
+                facts_has(bf, id, 0) ? ", mais déduit après coup" : "");
+        return 0;
+    }
+    print_literal(key, out);
+    if (!facts_has(bf, id, LIT_NEG(key))) {
+        fputs("  (non établi)\n", out);
+        return 0;
+    }
+    const JustificationEntry *e = key < j->nkeys ? &j->entries[key] : NULL;
+    if (!e || e->rule == 0 || e->rule > cbc->nrules) {
+        fputs("  (fait initial)\n", out);
+        return 0;
+    }
+    if (seen[key]) {
+        fputs("  (voir plus haut)\n", out);
+        return 0;
+    }
+    seen[key] = 1;
+    fputs("  [", out);
+    print_rule(cbc, e->rule - 1, out);
+    fprintf(out, ", passe %u]\n", (unsigned)e->pass);
+    return cbc->rules[e->rule - 1].npos + cbc->rules[e->rule - 1].nneg > 0;
+}
+
+/**
+ * Écrit l'arbre de preuve d'un fait à partir de l'enregistrement.
+ * @param j Enregistrement rempli par une inférence.
+ * @param cbc Base compilée de l'inférence.
+ * @param bf Base de faits après inférence.
+ * @param p Fait à expliquer.
+ * @param out Flux de sortie.
+ * @return 1 si le fait est établi, 0 sinon.
+ */
+int justification_print_tree(const Justification *j, const CompiledBC *cbc, const BaseFaits *bf, Proposition p, FILE *out) {
+    if (!j || !cbc || !bf || !out || p.id < 0) return 0;
+    int established = facts_has(bf, p.id, p.negated);
+    uint32_t root = LIT_MAKE(p.id, p.negated);
+    unsigned char *seen = (unsigned char*)calloc(j->nkeys ? j->nkeys : 1, 1);
+    // Explicit stacks: long chains would overflow a recursive walk
+    size_t cap = 64, depth = 0, prefix_cap = 256;
+    ProofFrame *stack = (ProofFrame*)malloc(cap * sizeof(ProofFrame));
+    char *prefix = (char*)malloc(prefix_cap);
+
+    if (print_node(j, cbc, bf, root, 0, seen, out)) {
+        stack[depth].key = root;
+        stack[depth].next = 0;
+        stack[depth].prefix_len = 0;
+        depth++;
+    }
+    while (depth > 0) {
+        ProofFrame *f = &stack[depth - 1];
+        const CompiledRule *h = &cbc->rules[j->entries[f->key].rule - 1];
+        uint32_t n = h->npos + h->nneg;
+        if (f->next == n) {
+            depth--;
+            continue;
+        }
+        uint32_t lit = cbc->premises[h->start + f->next++];
+        int last = f->next == n;
+        size_t plen = f->prefix_len;
+        fwrite(prefix, 1, plen, out);
+        fputs(last ? "└── " : "├── ", out);
+        if (!print_node(j, cbc, bf, lit, 1, seen, out)) continue;
+
+        // Children of this premise are indented under it
+        const char *pad = last ? "    " : "│   ";
+        size_t pad_len = strlen(pad);
+        if (plen + pad_len > prefix_cap) {
+            while (plen + pad_len > prefix_cap) prefix_cap *= 2;
+            prefix = (char*)realloc(prefix, prefix_cap);
+        }
+        memcpy(prefix + plen, pad, pad_len);
+        if (depth == cap) {
+            cap *= 2;
+            stack = (ProofFrame*)realloc(stack, cap * sizeof(ProofFrame));
+        }
+        stack[depth].key = lit;
+        stack[depth].next = 0;
+        stack[depth].prefix_len = plen + pad_len;
+        depth++;
+    }
+    free(prefix);
+    free(stack);
+    free(seen);
+    return established;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include "compiled.h"
+#include "proposition.h"
+
+struct BaseFaits;
+
+// Justification d'un fait: règle compilée qui l'a déduit et passe de
+// déclenchement.
+typedef struct JustificationEntry {
+    uint32_t rule;   // indice de règle compilée + 1 (0: fait non déduit)
+    uint32_t pass;   // passe de déclenchement (à partir de 1)
+} JustificationEntry;
+
+// Enregistrement des déductions, indexé par clé de fait (2*id + negated).
+// Alloué une fois pour une base: l'enregistrement pendant l'inférence est
+// une simple écriture, sans allocation.
+typedef struct Justification {
+    JustificationEntry *entries;
+    size_t nkeys;
+} Justification;
+
+/**
+ * Crée un enregistrement vide pour les symboles 0..nsyms-1.
+ * @param nsyms Nombre de symboles (base compilée: cbc->nsyms).
+ * @return Enregistrement, à libérer avec justification_free.
+ */
+Justification justification_create(size_t nsyms);
+
+/**
+ * Libère un enregistrement.
+ * @param j Enregistrement.
+ * @return Aucun.
+ */
+void justification_free(Justification *j);
+
+/**
+ * Oublie toutes les déductions enregistrées.
+ * @param j Enregistrement.
+ * @return Aucun.
+ */
+void justification_clear(Justification *j);
+
+/**
+ * Enregistre la déduction d'un fait (appelé par les moteurs).
+ * @param j Enregistrement (NULL: rien).
+ * @param key Clé du fait déduit (LIT_MAKE(id, negated)).
+ * @param rule Indice de la règle compilée déclenchée.
+ * @param pass Passe de déclenchement.
+ * @return Aucun.
+ */
+static inline void justification_record(Justification *j, uint32_t key, uint32_t rule, uint32_t pass) {
+    if (!j || key >= j->nkeys) return;
+    j->entries[key].rule = rule + 1;
+    j->entries[key].pass = pass;
+}
+
+/**
+ * Donne la justification d'un fait.
+ * @param j Enregistrement.
+ * @param p Fait.
+ * @param rule Sortie optionnelle: indice de la règle compilée.
+ * @param pass Sortie optionnelle: passe de déclenchement.
+ * @return 1 si le fait a été déduit, 0 sinon (fait initial ou absent).
+ */
+int justification_get(const Justification *j, Proposition p, uint32_t *rule, uint32_t *pass);
+
+/**
+ * Écrit l'arbre de preuve d'un fait à partir de l'enregistrement, sans
+ * relancer l'inférence: chaque fait déduit est suivi de sa règle, de sa
+ * passe puis des preuves de ses prémisses. Un sous-arbre déjà écrit est
+ * remplacé par un renvoi.
+ * @param j Enregistrement rempli par une inférence.
+ * @param cbc Base compilée de l'inférence (indices de règles).
+ * @param bf Base de faits après inférence.
+ * @param p Fait à expliquer.
+ * @param out Flux de sortie.
+ * @return 1 si le fait est établi (initial ou déduit), 0 sinon.
+ */
+int justification_print_tree(const Justification *j, const CompiledBC *cbc, const struct BaseFaits *bf, Proposition p, FILE *out);
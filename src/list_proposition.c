@@ -6,7 +6,16 @@
  * @return Liste initialisée, vide.
  */
 ListProposition listp_create() {
-    ListProposition l; l.head = l.tail = NULL; l.size = 0; return l;
+    return listp_create_in(NULL);
+}
+
+/**
+ * Crée une liste de propositions vide dont les nœuds sont alloués dans une arène.
+ * @param arena Arène propriétaire des nœuds (NULL: allocation classique).
+ * @return Liste initialisée, vide.
+ */
+ListProposition listp_create_in(Arena *arena) {
+    ListProposition l; l.head = l.tail = NULL; l.size = 0; l.arena = arena; return l;
 }
 
 /**
@@ -16,7 +25,7 @@ ListProposition listp_create() {
  */
 void listp_free(ListProposition *list) {
     if (!list) return;
-    ListPropositionNode *cur = list->head;
+    ListPropositionNode *cur = list->arena ? NULL : list->head; // arena nodes go with the arena
     while (cur) {
         ListPropositionNode *next = cur->next;
         proposition_free(&cur->value);
@@ -43,7 +52,9 @@ int listp_is_empty(const ListProposition *list) {
  */
 void listp_push_back(ListProposition *list, Proposition value) {
     if (!list) return;
-    ListPropositionNode *node = (ListPropositionNode*)malloc(sizeof(ListPropositionNode));
+    ListPropositionNode *node = list->arena
+        ? (ListPropositionNode*)arena_alloc(list->arena, sizeof(ListPropositionNode))
+        : (ListPropositionNode*)malloc(sizeof(ListPropositionNode));
     node->value = value;
     node->next = NULL;
     if (!list->tail) {
@@ -81,7 +92,7 @@ int listp_remove_first(ListProposition *list, const Proposition *value) {
             if (prev) prev->next = cur->next; else list->head = cur->next;
             if (cur == list->tail) list->tail = prev;
             proposition_free(&cur->value);
-            free(cur);
+            if (!list->arena) free(cur);
             list->size--;
             return 1;
         }
@@ -115,15 +126,20 @@ int listp_contains(const ListProposition *list, const Proposition *value) {
 
 int listp_remove_all_by_name(ListProposition *list, const char *name) {
     if (!list || !name) return 0;
+    return listp_remove_all_by_id(list, symbol_lookup(name));
+}
+
+int listp_remove_all_by_id(ListProposition *list, int id) {
+    if (!list || id == SYMBOL_NONE) return 0;
     int removed = 0;
     ListPropositionNode *prev = NULL, *cur = list->head;
     while (cur) {
-        if (cur->value.name && strcmp(cur->value.name, name) == 0) {
+        if (cur->value.id == id) {
             ListPropositionNode *next = cur->next;
             if (prev) prev->next = next; else list->head = next;
             if (cur == list->tail) list->tail = prev;
             proposition_free(&cur->value);
-            free(cur);
+            if (!list->arena) free(cur);
             cur = next;
             list->size--;
             removed++;
@@ -1,4 +1,5 @@
 #pragma once
+#include "arena.h"
 #include "proposition.h"
 
 typedef struct ListPropositionNode {
@@ -10,6 +11,7 @@ typedef struct ListProposition {
     ListPropositionNode *head;
     ListPropositionNode *tail;
     size_t size;
+    Arena *arena;   // si non NULL, les nœuds sont alloués dans cette arène
 } ListProposition;
 
 /**
@@ -18,6 +20,14 @@ typedef struct ListProposition {
  */
 ListProposition listp_create();
 
+/**
+ * Crée une liste de propositions vide dont les nœuds seront alloués dans
+ * une arène (libérés avec l'arène, pas un par un).
+ * @param arena Arène propriétaire des nœuds (NULL: allocation classique).
+ * @return Liste initialisée, vide.
+ */
+ListProposition listp_create_in(Arena *arena);
+
 /**
  * Libère une liste de propositions et son contenu.
  * @param list Pointeur vers la liste à libérer.
@@ -80,3 +90,12 @@ int listp_contains(const ListProposition *list, const Proposition *value);
  * @return Nombre d'éléments supprimés.
  */
 int listp_remove_all_by_name(ListProposition *list, const char *name);
+
+/**
+ * Supprime toutes les occurrences (positives et négatives) d'un symbole
+ * donné dans la liste.
+ * @param list Liste cible.
+ * @param id Identifiant du symbole ciblé.
+ * @return Nombre d'éléments supprimés.
+ */
+int listp_remove_all_by_id(ListProposition *list, int id);
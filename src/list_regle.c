@@ -6,7 +6,16 @@
  * @return Liste initialisée, vide.
  */
 ListRegle listr_create() {
-    ListRegle l; l.head = l.tail = NULL; l.size = 0; return l;
+    return listr_create_in(NULL);
+}
+
+/**
+ * Crée une liste de règles vide dont les nœuds sont alloués dans une arène.
+ * @param arena Arène propriétaire des nœuds (NULL: allocation classique).
+ * @return Liste initialisée, vide.
+ */
+ListRegle listr_create_in(Arena *arena) {
+    ListRegle l; l.head = l.tail = NULL; l.size = 0; l.arena = arena; return l;
 }
 
 /**
@@ -20,7 +29,7 @@ void listr_free(ListRegle *list) {
     while (cur) {
         ListRegleNode *next = cur->next;
         regle_free(&cur->value);
-        free(cur);
+        if (!list->arena) free(cur);
         cur = next;
     }
     list->head = list->tail = NULL; list->size = 0;
@@ -43,9 +52,14 @@ int listr_is_empty(const ListRegle *list) {
  */
 void listr_push_back(ListRegle *list, Regle value) {
     if (!list) return;
-    ListRegleNode *node = (ListRegleNode*)malloc(sizeof(ListRegleNode));
+    ListRegleNode *node = list->arena
+        ? (ListRegleNode*)arena_alloc(list->arena, sizeof(ListRegleNode))
+        : (ListRegleNode*)malloc(sizeof(ListRegleNode));
     node->value = value;
     node->next = NULL;
+    node->prev = list->tail;
+    node->concl_next = node->concl_prev = NULL;
+    node->key = 0;
     if (!list->tail) {
         list->head = list->tail = node;
     } else {
@@ -55,6 +69,20 @@ void listr_push_back(ListRegle *list, Regle value) {
     list->size++;
 }
 
+/**
+ * Détache un nœud de la liste sans le libérer.
+ * @param list Liste contenant le nœud.
+ * @param node Nœud à détacher.
+ * @return Aucun.
+ */
+void listr_unlink(ListRegle *list, ListRegleNode *node) {
+    if (!list || !node) return;
+    if (node->prev) node->prev->next = node->next; else list->head = node->next;
+    if (node->next) node->next->prev = node->prev; else list->tail = node->prev;
+    node->next = node->prev = NULL;
+    list->size--;
+}
+
 /**
  * Récupère la règle en tête de liste.
  * @param list Liste cible.
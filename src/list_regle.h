@@ -1,15 +1,22 @@
 #pragma once
+#include <stdint.h>
 #include "regle.h"
 
 typedef struct ListRegleNode {
     Regle value;
     struct ListRegleNode *next;
+    struct ListRegleNode *prev;
+    // Règles de même conclusion, chaînées par l'index de la BC
+    struct ListRegleNode *concl_next;
+    struct ListRegleNode *concl_prev;
+    uint64_t key;   // clé de la règle dans les versions de la BC (voir version.h)
 } ListRegleNode;
 
 typedef struct ListRegle {
     ListRegleNode *head;
     ListRegleNode *tail;
     size_t size;
+    Arena *arena;   // si non NULL, les nœuds sont alloués dans cette arène
 } ListRegle;
 
 /**
@@ -18,6 +25,13 @@ typedef struct ListRegle {
  */
 ListRegle listr_create();
 
+/**
+ * Crée une liste de règles vide dont les nœuds seront alloués dans une arène.
+ * @param arena Arène propriétaire des nœuds (NULL: allocation classique).
+ * @return Liste initialisée, vide.
+ */
+ListRegle listr_create_in(Arena *arena);
+
 /**
  * Libère une liste de règles et son contenu.
  * @param list Pointeur vers la liste à libérer.
@@ -40,6 +54,15 @@ int listr_is_empty(const ListRegle *list);
  */
 void listr_push_back(ListRegle *list, Regle value);
 
+/**
+ * Détache un nœud de la liste en temps constant, sans le libérer ni
+ * libérer sa règle.
+ * @param list Liste contenant le nœud.
+ * @param node Nœud à détacher.
+ * @return Aucun.
+ */
+void listr_unlink(ListRegle *list, ListRegleNode *node);
+
 /**
  * Récupère la règle en tête de liste.
  * @param list Liste cible.
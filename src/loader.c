@@ -0,0 +1,218 @@
+#include <stdlib.h>
+#include <string.h>
+#include "loader.h"
+#include "proposition.h"
+#include "regle.h"
+
+typedef struct Parser {
+    BC *bc;
+    Proposition *lits;   // literals of the current rule, conclusion last
+    size_t nlits;
+    size_t cap;
+    size_t line;
+    size_t nrules;
+    LoadError *err;
+} Parser;
+
+static int fail(Parser *ps, const char *line_start, const char *at, const char *msg) {
+    if (ps->err) {
+        ps->err->line = ps->line;
+        ps->err->column = (size_t)(at - line_start) + 1;
+        snprintf(ps->err->message, sizeof(ps->err->message), "%s", msg);
+    }
+    return 0;
+}
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// "¬" in UTF-8
+static int is_not_sign(const char *p, const char *end) {
+    return end - p >= 2 && (unsigned char)p[0] == 0xC2 && (unsigned char)p[1] == 0xAC;
+}
+
+static int is_name_char(const char *p, const char *end) {
+    unsigned char c = (unsigned char)*p;
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) return 1;
+    if (c == '_' || c == '-' || c == '.') return 1;
+    return c >= 0x80 && !is_not_sign(p, end);
+}
+
+static const char *skip_space(const char *p, const char *end) {
+    while (p < end && is_space(*p)) p++;
+    return p;
+}
+
+static int is_arrow(const char *p, const char *end) {
+    return end - p >= 2 && p[0] == '=' && p[1] == '>';
+}
+
+static int push_literal(Parser *ps, const char *line_start, const char **pp, const char *end) {
+    const char *p = *pp;
+    int neg = 0;
+    if (p < end && *p == '!') { neg = 1; p++; }
+    else if (is_not_sign(p, end)) { neg = 1; p += 2; }
+    if (neg) p = skip_space(p, end);
+    const char *name = p;
+    while (p < end && is_name_char(p, end)) p++;
+    if (p == name) return fail(ps, line_start, name, "expected a proposition name");
+    if (ps->nlits == ps->cap) {
+        ps->cap = ps->cap ? ps->cap * 2 : 16;
+        ps->lits = (Proposition*)realloc(ps->lits, ps->cap * sizeof(Proposition));
+    }
+    ps->lits[ps->nlits++] = proposition_from_id(symbol_intern_n(name, (size_t)(p - name)), neg);
+    *pp = p;
+    return 1;
+}
+
+/*
+ * Parses one line (without its '\n'). Literals are collected first and the
+ * rule is only built once the whole line is valid, so a syntax error never
+ * leaves a half-built rule in the base.
+ */
+static int parse_line(Parser *ps, const char *line_start, const char *end) {
+    const char *p = skip_space(line_start, end);
+    if (p == end || *p == '#') return 1;
+    ps->nlits = 0;
+    if (!is_arrow(p, end)) {
+        for (;;) {
+            if (!push_literal(ps, line_start, &p, end)) return 0;
+            p = skip_space(p, end);
+            if (p < end && *p == '&') {
+                p = skip_space(p + 1, end);
+                continue;
+            }
+            if (is_arrow(p, end)) break;
+            return fail(ps, line_start, p, "expected '&' or '=>'");
+        }
+    }
+    p = skip_space(p + 2, end);
+    if (!push_literal(ps, line_start, &p, end)) return 0;
+    p = skip_space(p, end);
+    if (p < end && *p != '#') return fail(ps, line_start, p, "expected end of line after the conclusion");
+
+    Regle r = regle_create_in(ps->bc->arena);
+    for (size_t i = 0; i + 1 < ps->nlits; ++i) regle_add_premise(&r, ps->lits[i]);
+    regle_set_conclusion(&r, ps->lits[ps->nlits - 1]);
+    bc_add_regle(ps->bc, r);
+    ps->nrules++;
+    return 1;
+}
+
+static Parser parser_create(BC *bc, LoadError *err) {
+    Parser ps;
+    memset(&ps, 0, sizeof(ps));
+    ps.bc = bc;
+    ps.err = err;
+    if (err) memset(err, 0, sizeof(*err));
+    return ps;
+}
+
+static int parser_finish(Parser *ps, int ok, size_t *nrules) {
+    free(ps->lits);
+    if (nrules) *nrules = ps->nrules;
+    return ok;
+}
+
+/**
+ * Charge des règles depuis un flux, une règle par ligne.
+ * @param bc Base de connaissances (règles ajoutées en queue).
+ * @param in Flux d'entrée.
+ * @param nrules Sortie optionnelle: nombre de règles ajoutées.
+ * @param err Sortie optionnelle: description de l'erreur.
+ * @return 1 si succès, 0 en cas d'erreur.
+ */
+int loader_load_stream(BC *bc, FILE *in, size_t *nrules, LoadError *err) {
+    if (nrules) *nrules = 0;
+    if (!bc || !in) return 0;
+    Parser ps = parser_create(bc, err);
+    char *buf = (char*)malloc(LOADER_BUFFER_SIZE);
+    size_t have = 0;
+    int ok = 1, eof = 0;
+    while (ok && !eof) {
+        size_t n = fread(buf + have, 1, LOADER_BUFFER_SIZE - have, in);
+        if (n == 0) {
+            if (ferror(in)) {
+                if (err) snprintf(err->message, sizeof(err->message), "read error");
+                ok = 0;
+                break;
+            }
+            eof = 1;
+        }
+        have += n;
+        // Parse every complete line; keep the unfinished tail for the next read
+        char *line = buf, *end = buf + have;
+        char *nl;
+        while (ok && (nl = (char*)memchr(line, '\n', (size_t)(end - line))) != NULL) {
+            ps.line++;
+            ok = parse_line(&ps, line, nl);
+            line = nl + 1;
+        }
+        if (!ok) break;
+        have = (size_t)(end - line);
+        if (eof) {
+            if (have) {
+                ps.line++;
+                ok = parse_line(&ps, line, end);
+            }
+        } else if (have == LOADER_BUFFER_SIZE) {
+            ps.line++;
+            ok = fail(&ps, line, line, "line too long");
+        } else if (line != buf) {
+            memmove(buf, line, have);
+        }
+    }
+    free(buf);
+    return parser_finish(&ps, ok, nrules);
+}
+
+/**
+ * Charge des règles depuis un fichier ("-": entrée standard).
+ * @param bc Base de connaissances (règles ajoutées en queue).
+ * @param path Chemin du fichier.
+ * @param nrules Sortie optionnelle: nombre de règles ajoutées.
+ * @param err Sortie optionnelle: description de l'erreur.
+ * @return 1 si succès, 0 en cas d'erreur.
+ */
+int loader_load_file(BC *bc, const char *path, size_t *nrules, LoadError *err) {
+    if (nrules) *nrules = 0;
+    if (!path) return 0;
+    if (strcmp(path, "-") == 0) return loader_load_stream(bc, stdin, nrules, err);
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        if (err) {
+            memset(err, 0, sizeof(*err));
+            snprintf(err->message, sizeof(err->message), "cannot open file");
+        }
+        return 0;
+    }
+    int ok = loader_load_stream(bc, f, nrules, err);
+    fclose(f);
+    return ok;
+}
+
+/**
+ * Charge des règles depuis un texte en mémoire.
+ * @param bc Base de connaissances (règles ajoutées en queue).
+ * @param text Texte source.
+ * @param len Longueur du texte en octets.
+ * @param nrules Sortie optionnelle: nombre de règles ajoutées.
+ * @param err Sortie optionnelle: description de l'erreur.
+ * @return 1 si succès, 0 en cas d'erreur.
+ */
+int loader_load_text(BC *bc, const char *text, size_t len, size_t *nrules, LoadError *err) {
+    if (nrules) *nrules = 0;
+    if (!bc || (!text && len)) return 0;
+    Parser ps = parser_create(bc, err);
+    const char *line = text, *end = text + len;
+    int ok = 1;
+    while (ok && line < end) {
+        const char *nl = (const char*)memchr(line, '\n', (size_t)(end - line));
+        ps.line++;
+        ok = parse_line(&ps, line, nl ? nl : end);
+        if (!nl) break;
+        line = nl + 1;
+    }
+    return parser_finish(&ps, ok, nrules);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include "bc.h"
+
+// Taille du tampon de lecture; une ligne ne peut pas la dépasser.
+#define LOADER_BUFFER_SIZE (1 << 16)
+
+// Erreur de chargement, localisée dans le texte source.
+typedef struct LoadError {
+    size_t line;        // ligne (à partir de 1), 0 si erreur d'entrée/sortie
+    size_t column;      // colonne en octets (à partir de 1)
+    char message[128];
+} LoadError;
+
+/**
+ * Charge des règles depuis un flux, une règle par ligne:
+ *   A & B & !C => R1      (prémisses séparées par '&', négation '!' ou '¬')
+ *   => R0                 (règle sans prémisse)
+ *   # commentaire         (jusqu'à la fin de la ligne; lignes vides ignorées)
+ * Les noms (lettres, chiffres, '_', '-', '.', octets UTF-8) sont internés à la
+ * volée et les règles sont allouées dans l'arène de la base: le flux est lu
+ * par un tampon fixe, sans copie par ligne.
+ * @param bc Base de connaissances (règles ajoutées en queue).
+ * @param in Flux d'entrée.
+ * @param nrules Sortie optionnelle: nombre de règles ajoutées.
+ * @param err Sortie optionnelle: description de l'erreur.
+ * @return 1 si succès, 0 en cas d'erreur (les règles lues avant restent dans bc).
+ */
+int loader_load_stream(BC *bc, FILE *in, size_t *nrules, LoadError *err);
+
+/**
+ * Charge des règles depuis un fichier ("-": entrée standard).
+ * @param bc Base de connaissances (règles ajoutées en queue).
+ * @param path Chemin du fichier.
+ * @param nrules Sortie optionnelle: nombre de règles ajoutées.
+ * @param err Sortie optionnelle: description de l'erreur.
+ * @return 1 si succès, 0 en cas d'erreur.
+ */
+int loader_load_file(BC *bc, const char *path, size_t *nrules, LoadError *err);
+
+/**
+ * Charge des règles depuis un texte en mémoire (même format).
+ * @param bc Base de connaissances (règles ajoutées en queue).
+ * @param text Texte source.
+ * @param len Longueur du texte en octets.
+ * @param nrules Sortie optionnelle: nombre de règles ajoutées.
+ * @param err Sortie optionnelle: description de l'erreur.
+ * @return 1 si succès, 0 en cas d'erreur.
+ */
+int loader_load_text(BC *bc, const char *text, size_t len, size_t *nrules, LoadError *err);
@@ -5,7 +5,16 @@
 #include "regle.h"
 #include "bc.h"
 #include "inference.h"
+#include "justification.h"
+#include "backward.h"
+#include "export.h"
+#include "loader.h"
 #include "print.h"
+#include "serve.h"
+#include "server.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "sweep.h"
 #include "ui.h"
 #include <string.h>
 
@@ -15,97 +24,368 @@
  * @return Aucun.
  */
 static void print_facts(const BaseFaits *bf) {
-  const ListProposition *lp = &bf->facts;
-  const ListPropositionNode *cur = lp->head;
+  size_t it = 0;
+  Proposition p;
   printf("Faits connus:\n");
-  while (cur) {
-    const Proposition *p = &cur->value;
-    printf(" - %s%s\n", p->negated ? "¬" : "", p->name);
-    cur = cur->next;
+  while (facts_next(bf, &it, &p)) {
+    printf(" - %s%s\n", p.negated ? "¬" : "", proposition_name(&p));
   }
 }
 
-int main(int argc, char *argv[]) {
-  int text_only = 0;
-  for (int i = 1; i < argc; ++i) {
-    if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--text-only") == 0) {
-      text_only = 1;
+/**
+ * Affiche l'arbre de preuve de chaque fait d'une liste "R4,!X".
+ * @param just Justifications enregistrées pendant l'inférence.
+ * @param cbc Base compilée de l'inférence.
+ * @param bf Base de faits après inférence.
+ * @param list Liste de noms séparés par des virgules.
+ * @return Aucun.
+ */
+static void print_why(const Justification *just, const CompiledBC *cbc, const BaseFaits *bf, const char *list) {
+  const char *p = list;
+  while (*p) {
+    const char *end = strchr(p, ',');
+    if (!end) end = p + strlen(p);
+    int neg = 0;
+    if (*p == '!') { neg = 1; p++; }
+    else if (strncmp(p, "¬", strlen("¬")) == 0) { neg = 1; p += strlen("¬"); }
+    if (end > p) {
+      printf("\nPourquoi %s%.*s:\n", neg ? "¬" : "", (int)(end - p), p);
+      justification_print_tree(just, cbc, bf, proposition_from_id(symbol_intern_n(p, (size_t)(end - p)), neg), stdout);
     }
+    p = *end ? end + 1 : end;
   }
+}
 
-  BC bc = bc_create();
-
+/**
+ * Construit la base d'exemple du sujet (diagnostic auto simplifié).
+ * @param bc Base de connaissances à remplir.
+ * @param bf Base de faits à remplir (entrées A à E).
+ * @return Aucun.
+ */
+static void build_example(BC *bc, BaseFaits *bf) {
   // Nouvelles règles selon la spécification:
   // Entrées: A, B, C, D, E (présents comme faits initiaux)
   // R1: A et B et C => R1
-  Regle r1 = regle_create();
+  Regle r1 = regle_create_in(bc->arena);
   regle_add_premise(&r1, proposition_make("A", 0));
   regle_add_premise(&r1, proposition_make("B", 0));
   regle_add_premise(&r1, proposition_make("C", 0));
   regle_set_conclusion(&r1, proposition_make("R1", 0));
-  bc_add_regle(&bc, r1);
+  bc_add_regle(bc, r1);
 
   // R2: ¬C et D et E => R2
-  Regle r2 = regle_create();
+  Regle r2 = regle_create_in(bc->arena);
   regle_add_premise(&r2, proposition_make("C", 1));
   regle_add_premise(&r2, proposition_make("D", 0));
   regle_add_premise(&r2, proposition_make("E", 0));
   regle_set_conclusion(&r2, proposition_make("R2", 0));
-  bc_add_regle(&bc, r2);
+  bc_add_regle(bc, r2);
 
   // R3: A et C => R3
-  Regle r3 = regle_create();
+  Regle r3 = regle_create_in(bc->arena);
   regle_add_premise(&r3, proposition_make("A", 0));
   regle_add_premise(&r3, proposition_make("C", 0));
   regle_set_conclusion(&r3, proposition_make("R3", 0));
-  bc_add_regle(&bc, r3);
+  bc_add_regle(bc, r3);
 
   // R4: R1 et D et E => R4
-  Regle r4 = regle_create();
+  Regle r4 = regle_create_in(bc->arena);
   regle_add_premise(&r4, proposition_make("R1", 0));
   regle_add_premise(&r4, proposition_make("D", 0));
   regle_add_premise(&r4, proposition_make("E", 0));
   regle_set_conclusion(&r4, proposition_make("R4", 0));
-  bc_add_regle(&bc, r4);
+  bc_add_regle(bc, r4);
 
   // R5: ¬R3 et B => R5
-  Regle r5 = regle_create();
+  Regle r5 = regle_create_in(bc->arena);
   regle_add_premise(&r5, proposition_make("R3", 1));
   regle_add_premise(&r5, proposition_make("B", 0));
   regle_set_conclusion(&r5, proposition_make("R5", 0));
-  bc_add_regle(&bc, r5);
+  bc_add_regle(bc, r5);
 
   // Base de faits initiale: A, B, C, D, E
+  facts_add(bf, proposition_make("A", 0));
+  facts_add(bf, proposition_make("B", 0));
+  facts_add(bf, proposition_make("C", 0));
+  facts_add(bf, proposition_make("D", 0));
+  facts_add(bf, proposition_make("E", 0));
+}
+
+/**
+ * Ajoute des faits donnés sous la forme "A,B,!C" (négation '!' ou '¬').
+ * @param bf Base de faits.
+ * @param list Liste de noms séparés par des virgules.
+ * @return Aucun.
+ */
+static void add_facts_list(BaseFaits *bf, const char *list) {
+  const char *p = list;
+  while (*p) {
+    const char *end = strchr(p, ',');
+    if (!end) end = p + strlen(p);
+    int neg = 0;
+    if (*p == '!') { neg = 1; p++; }
+    else if (strncmp(p, "¬", strlen("¬")) == 0) { neg = 1; p += strlen("¬"); }
+    if (end > p) facts_add(bf, proposition_from_id(symbol_intern_n(p, (size_t)(end - p)), neg));
+    p = *end ? end + 1 : end;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int text_only = 0;
+  InferenceEngine engine = ENGINE_NAIVE;
+  const char *goal = NULL;
+  const char *sweep_path = NULL;
+  int threads = 0;
+  const char *rules_path = NULL;
+  const char *facts_list = NULL;
+  const char *save_path = NULL;
+  const char *snapshot_path = NULL;
+  int show_stats = 0;
+  const char *why = NULL;
+  const char *export_path = NULL;
+  ExportFormat export_fmt = EXPORT_DOT;
+  int overlay = 0;
+  int serve_stdio = 0;
+  const char *serve_unix = NULL;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--text-only") == 0) {
+      text_only = 1;
+    } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+      if (!inference_engine_from_name(argv[++i], &engine)) {
+        fprintf(stderr, "Error: unknown engine '%s' (expected naive|agenda|stratified).\n", argv[i]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--goal") == 0 && i + 1 < argc) {
+      goal = argv[++i];
+    } else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+      sweep_path = argv[++i];
+    } else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) {
+      rules_path = argv[++i];
+    } else if (strcmp(argv[i], "--facts") == 0 && i + 1 < argc) {
+      facts_list = argv[++i];
+    } else if (strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < argc) {
+      save_path = argv[++i];
+    } else if (strcmp(argv[i], "--load-snapshot") == 0 && i + 1 < argc) {
+      snapshot_path = argv[++i];
+    } else if (strcmp(argv[i], "--why") == 0 && i + 1 < argc) {
+      why = argv[++i];
+    } else if (strcmp(argv[i], "--export") == 0 && i + 2 < argc) {
+      if (!export_format_from_name(argv[++i], &export_fmt)) {
+        fprintf(stderr, "Error: unknown export format '%s' (expected dot|graphml).\n", argv[i]);
+        return 1;
+      }
+      export_path = argv[++i];
+    } else if (strcmp(argv[i], "--overlay") == 0) {
+      overlay = 1;
+    } else if (strcmp(argv[i], "--serve-stdio") == 0) {
+      serve_stdio = 1;
+    } else if (strcmp(argv[i], "--serve-unix") == 0 && i + 1 < argc) {
+      serve_unix = argv[++i];
+    } else if (strcmp(argv[i], "--stats") == 0) {
+      show_stats = 1;
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    }
+  }
+  // The stdio service always evaluates bit-sliced batches with naive semantics
+  if (serve_stdio && engine != ENGINE_NAIVE) {
+    fprintf(stderr, "Error: --serve-stdio only runs the naive engine; use --serve-unix for --engine %s.\n",
+            inference_engine_name(engine));
+    return 1;
+  }
+
+  BC bc = bc_create();
   BaseFaits bf = facts_create();
-  facts_add(&bf, proposition_make("A", 0));
-  facts_add(&bf, proposition_make("B", 0));
-  facts_add(&bf, proposition_make("C", 0));
-  facts_add(&bf, proposition_make("D", 0));
-  facts_add(&bf, proposition_make("E", 0));
+  // Base compilée: projetée depuis un instantané (--load-snapshot) ou
+  // compilée à la demande à partir de bc.
+  Snapshot snap;
+  memset(&snap, 0, sizeof(snap));
+  const CompiledBC *cbc = NULL;
+  int status = 0;
+  if (snapshot_path) {
+    const char *err = NULL;
+    if (!snapshot_open(&snap, snapshot_path, &err)) {
+      fprintf(stderr, "Error: %s: %s\n", snapshot_path, err);
+      status = 1;
+    } else {
+      cbc = &snap.cbc;
+      if (!facts_list) {
+        int *inputs = NULL;
+        size_t n = compiled_input_symbols(cbc, &inputs);
+        for (size_t i = 0; i < n; ++i) facts_add(&bf, proposition_from_id(inputs[i], 0));
+        free(inputs);
+      }
+    }
+  } else if (rules_path) {
+    LoadError err;
+    size_t nrules = 0;
+    if (!loader_load_file(&bc, rules_path, &nrules, &err)) {
+      if (err.line) fprintf(stderr, "%s:%zu:%zu: error: %s\n", rules_path, err.line, err.column, err.message);
+      else fprintf(stderr, "Error: %s: %s\n", rules_path, err.message);
+      status = 1;
+    } else if (!facts_list) {
+      // Sans --facts, toutes les entrées de la base sont vraies
+      int *inputs = NULL;
+      size_t n = bc_input_symbols(&bc, &inputs);
+      for (size_t i = 0; i < n; ++i) facts_add(&bf, proposition_from_id(inputs[i], 0));
+      free(inputs);
+    }
+  } else {
+    build_example(&bc, &bf);
+  }
+  if (status == 0 && facts_list) {
+    facts_clear(&bf);
+    add_facts_list(&bf, facts_list);
+  }
 
-  if (text_only) {
+  if (status != 0) {
+    // Chargement échoué: rien d'autre à faire
+  } else if (save_path) {
+    // Instantané binaire de la base compilée et des symboles
+    CompiledBC fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    if (!cbc) fresh = bc_compile(&bc);
+    const char *err = NULL;
+    if (!snapshot_save(cbc ? cbc : &fresh, save_path, &err)) {
+      fprintf(stderr, "Error: %s: %s\n", save_path, err);
+      status = 1;
+    } else {
+      const CompiledBC *saved = cbc ? cbc : &fresh;
+      printf("Instantané écrit dans %s (%u règles, %u symboles)\n", save_path, saved->nrules, saved->nsyms);
+    }
+    compiled_free(&fresh);
+  } else if (sweep_path) {
+    // Table de vérité de toutes les combinaisons d'entrées ("-": sortie standard)
+    FILE *out = strcmp(sweep_path, "-") == 0 ? stdout : fopen(sweep_path, "w");
+    uint64_t rows = 0;
+    int ok = 0;
+    if (!out) {
+      fprintf(stderr, "Error: cannot open '%s' for writing.\n", sweep_path);
+    } else {
+      ok = cbc ? inference_sweep_compiled(cbc, out, threads, &rows) : inference_sweep(&bc, out, threads, &rows);
+      if (out != stdout && fclose(out) != 0) ok = 0;
+      if (!ok) fprintf(stderr, "Error: sweep failed (more than %d inputs or write error).\n", SWEEP_MAX_INPUTS);
+      else if (out != stdout) printf("%llu combinaisons écrites dans %s\n", (unsigned long long)rows, sweep_path);
+    }
+    status = ok ? 0 : 1;
+  } else if (export_path) {
+    // Graphe des règles pour un outil externe ("-": sortie standard), avec
+    // les valeurs de vérité après inférence si --overlay
+    if (overlay) {
+      int ran = cbc ? inference_run_compiled(cbc, &bf, engine) : inference_run(&bc, &bf, engine);
+      if (!ran) fprintf(stderr, "Error: knowledge base is not stratifiable (negation in a cycle).\n");
+    }
+    FILE *out = strcmp(export_path, "-") == 0 ? stdout : fopen(export_path, "w");
+    int ok = 0;
+    if (!out) {
+      fprintf(stderr, "Error: cannot open '%s' for writing.\n", export_path);
+    } else {
+      const BaseFaits *truth = overlay ? &bf : NULL;
+      ok = cbc ? export_compiled(cbc, export_fmt, truth, out) : export_bc(&bc, export_fmt, truth, out);
+      if (out != stdout && fclose(out) != 0) ok = 0;
+      if (!ok) fprintf(stderr, "Error: write error on '%s'.\n", export_path);
+      else if (out != stdout) printf("Graphe %s écrit dans %s\n", export_format_name(export_fmt), export_path);
+    }
+    status = ok ? 0 : 1;
+  } else if (serve_stdio) {
+    // Une base de faits par ligne sur l'entrée standard, les faits déduits
+    // sur la sortie standard; la base n'est chargée qu'une fois
+    CompiledBC fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    if (!cbc) fresh = bc_compile(&bc);
+    fflush(stdout);
+    if (!serve_stream(cbc ? cbc : &fresh, 0, 1, NULL)) {
+      fprintf(stderr, "Error: write error on standard output.\n");
+      status = 1;
+    }
+    compiled_free(&fresh);
+  } else if (serve_unix) {
+    // Serveur multi-clients sur une socket Unix, jusqu'à SIGINT / SIGTERM
+    CompiledBC fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    if (!cbc) fresh = bc_compile(&bc);
+    const char *err = NULL;
+    Server *server = server_create(cbc ? cbc : &fresh, serve_unix, engine, threads, &err);
+    if (!server) {
+      fprintf(stderr, "Error: %s: %s\n", serve_unix, err);
+      status = 1;
+    } else {
+      printf("En écoute sur %s (moteur %s, %d threads d'inférence)\n", serve_unix, inference_engine_name(engine),
+             server_worker_count(server));
+      fflush(stdout);
+      uint64_t served = 0;
+      if (!server_run(server, &served)) {
+        fprintf(stderr, "Error: event loop failed.\n");
+        status = 1;
+      }
+      printf("%llu requêtes servies\n", (unsigned long long)served);
+      server_free(server);
+    }
+    compiled_free(&fresh);
+  } else if (text_only) {
     // Mode texte: afficher les faits avant/après inférence et le graphe ASCII
     printf("Avant inférence:\n");
     print_facts(&bf);
-    inference_forward_chain(&bc, &bf);
+    if (goal) {
+      // Chaînage arrière sur une copie: seuls les sous-buts utiles sont dérivés
+      BaseFaits q = facts_copy(&bf);
+      int proven;
+      if (cbc) {
+        BackwardIndex idx = backward_index_create(cbc);
+        proven = backward_prove(&idx, &q, proposition_make(goal, 0));
+        backward_index_free(&idx);
+      } else {
+        proven = inference_backward_chain(&bc, &q, proposition_make(goal, 0));
+      }
+      printf("\nBut %s: %s\n", goal, proven ? "prouvé" : "non prouvé");
+      facts_free(&q);
+    }
+    InferenceStats stats;
+    stats_reset(&stats);
+    InferenceStats *st = show_stats ? &stats : NULL;
+    // Justifications pour --why, indexées sur tous les symboles connus
+    Justification just = justification_create((size_t)symbol_count());
+    Justification *jp = why ? &just : NULL;
+    int ran = cbc ? inference_run_compiled_stats(cbc, &bf, engine, st, jp) : inference_run_stats(&bc, &bf, engine, st, jp);
+    if (!ran) {
+      fprintf(stderr, "Error: knowledge base is not stratifiable (negation in a cycle).\n");
+    }
     printf("\nAprès inférence:\n");
     print_facts(&bf);
-    printf("\nGraphe de la base de connaissances:\n");
-    bc_print_ascii(&bc);
+    if (why) {
+      // L'arbre se lit sur la forme compilée (mêmes indices de règles)
+      CompiledBC fresh;
+      memset(&fresh, 0, sizeof(fresh));
+      if (!cbc) fresh = bc_compile(&bc);
+      print_why(&just, cbc ? cbc : &fresh, &bf, why);
+      compiled_free(&fresh);
+    }
+    justification_free(&just);
+    if (show_stats) {
+      printf("\n");
+      stats_print(&stats, stdout);
+    }
+    if (!cbc) {
+      printf("\nGraphe de la base de connaissances:\n");
+      bc_print_ascii(&bc);
+    }
+  } else if (cbc) {
+    fprintf(stderr, "Error: the interface edits rules and cannot run on a snapshot; use -t/--text-only.\n");
+    status = 1;
   } else {
 #ifdef HAVE_CURSES
     // Lance l'interface ncurses
     run_ui(&bc);
 #else
     fprintf(stderr, "Error: ncurses not installed/detected. Run with -t/--text-only to print the example knowledge base.\n");
-    bc_free(&bc);
-    facts_free(&bf);
-    return 1;
+    status = 1;
 #endif
   }
 
   // Cleanup
   bc_free(&bc);
   facts_free(&bf);
-  return 0;
+  if (snap.map) snapshot_close(&snap);
+  symbols_reset();
+  return status;
 }
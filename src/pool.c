@@ -0,0 +1,169 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pool.h"
+
+// Fact sets claimed at once by a worker: small enough to balance uneven
+// closures, large enough to keep the shared counter out of the hot path.
+#define POOL_CHUNK 8
+
+static void run_one(InferencePool *pool, PoolWorker *w, size_t i) {
+    BaseFaits *bf = &pool->outputs[i];
+    *bf = facts_copy(&pool->inputs[i]);
+    switch (pool->engine) {
+    case ENGINE_AGENDA: inference_forward_chain_agenda_scratch(pool->cbc, bf, &w->agenda); break;
+    case ENGINE_STRATIFIED: strata_forward_chain(pool->cbc, &pool->strata, bf); break;
+    case ENGINE_NAIVE:
+    default: inference_forward_chain_compiled(pool->cbc, bf); break;
+    }
+}
+
+static void *pool_main(void *arg) {
+    PoolWorker *w = (PoolWorker*)arg;
+    InferencePool *pool = w->pool;
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->generation == seen) pthread_cond_wait(&pool->work, &pool->lock);
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        size_t n = pool->n, i;
+        while ((i = __atomic_fetch_add(&pool->next, POOL_CHUNK, __ATOMIC_RELAXED)) < n) {
+            size_t end = i + POOL_CHUNK < n ? i + POOL_CHUNK : n;
+            for (; i < end; ++i) run_one(pool, w, i);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+/**
+ * Démarre un groupe de threads d'inférence.
+ * @param cbc Base compilée (partagée, doit survivre au groupe).
+ * @param engine Moteur utilisé pour chaque base de faits.
+ * @param workers Nombre de threads (<= 0: nombre de cœurs).
+ * @return Groupe démarré.
+ */
+InferencePool *inference_pool_create(const CompiledBC *cbc, InferenceEngine engine, int workers) {
+    if (!cbc) return NULL;
+    InferencePool *pool = (InferencePool*)calloc(1, sizeof(InferencePool));
+    pool->cbc = cbc;
+    pool->engine = engine;
+    pool->accepted = 1;
+    if (engine == ENGINE_STRATIFIED) pool->accepted = inference_stratify(cbc, &pool->strata);
+    if (workers <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = n > 0 ? (int)n : 1;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->workers = (PoolWorker*)calloc((size_t)workers, sizeof(PoolWorker));
+    for (int t = 0; t < workers; ++t) {
+        PoolWorker *w = &pool->workers[pool->nworkers];
+        w->pool = pool;
+        if (engine == ENGINE_AGENDA) w->agenda = agenda_scratch_create(cbc);
+        if (pthread_create(&w->thread, NULL, pool_main, w) != 0) {
+            agenda_scratch_free(&w->agenda);
+            break;
+        }
+        pool->nworkers++;
+    }
+    return pool;
+}
+
+/**
+ * Calcule la clôture de n bases de faits en parallèle.
+ * @param pool Groupe de threads.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées).
+ * @param n Nombre de bases de faits.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_pool_run(InferencePool *pool, const BaseFaits *inputs, BaseFaits *outputs, size_t n) {
+    if (!pool || !inputs || !outputs) return 0;
+    if (!pool->accepted) {
+        for (size_t i = 0; i < n; ++i) outputs[i] = facts_copy(&inputs[i]);
+        return 0;
+    }
+    if (n == 0) return 1;
+    if (pool->nworkers == 0) {
+        // No thread could be started: run inline with a scratch of our own
+        PoolWorker self;
+        memset(&self, 0, sizeof(self));
+        self.pool = pool;
+        if (pool->engine == ENGINE_AGENDA) self.agenda = agenda_scratch_create(pool->cbc);
+        pool->inputs = inputs;
+        pool->outputs = outputs;
+        for (size_t i = 0; i < n; ++i) run_one(pool, &self, i);
+        agenda_scratch_free(&self.agenda);
+        return 1;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->inputs = inputs;
+    pool->outputs = outputs;
+    pool->n = n;
+    pool->next = 0;
+    pool->busy = pool->nworkers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work);
+    while (pool->busy > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pool->inputs = NULL;
+    pool->outputs = NULL;
+    pool->n = 0;
+    pthread_mutex_unlock(&pool->lock);
+    return 1;
+}
+
+/**
+ * Arrête les threads et libère le groupe.
+ * @param pool Groupe de threads.
+ * @return Aucun.
+ */
+void inference_pool_free(InferencePool *pool) {
+    if (!pool) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (int t = 0; t < pool->nworkers; ++t) {
+        pthread_join(pool->workers[t].thread, NULL);
+        agenda_scratch_free(&pool->workers[t].agenda);
+    }
+    free(pool->workers);
+    if (pool->engine == ENGINE_STRATIFIED) strata_free(&pool->strata);
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+/**
+ * Calcule la clôture de n bases de faits avec un groupe temporaire.
+ * @param bc Base de connaissances.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées).
+ * @param n Nombre de bases de faits.
+ * @param workers Nombre de threads (<= 0: nombre de cœurs).
+ * @param engine Moteur à utiliser.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_parallel(const BC *bc, const BaseFaits *inputs, BaseFaits *outputs, size_t n,
+                       int workers, InferenceEngine engine) {
+    if (!bc) return 0;
+    CompiledBC cbc = bc_compile(bc);
+    InferencePool *pool = inference_pool_create(&cbc, engine, workers);
+    int ok = inference_pool_run(pool, inputs, outputs, n);
+    inference_pool_free(pool);
+    compiled_free(&cbc);
+    return ok;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <pthread.h>
+#include "compiled.h"
+#include "inference.h"
+#include "stratify.h"
+
+typedef struct PoolWorker {
+    struct InferencePool *pool;
+    pthread_t thread;
+    AgendaScratch agenda;    // état de travail propre au thread
+} PoolWorker;
+
+// Groupe fixe de threads évaluant des bases de faits en parallèle sur une
+// même base compilée. La base est partagée en lecture seule (aucun verrou);
+// chaque thread possède son état de travail.
+typedef struct InferencePool {
+    const CompiledBC *cbc;
+    InferenceEngine engine;
+    Strata strata;           // strates précalculées (moteur stratifié)
+    int accepted;            // 0: la base est rejetée par le moteur
+    int nworkers;
+    PoolWorker *workers;
+    pthread_mutex_t lock;
+    pthread_cond_t work;     // nouveau lot ou arrêt
+    pthread_cond_t done;     // tous les threads ont fini le lot
+    // Lot en cours
+    const BaseFaits *inputs;
+    BaseFaits *outputs;
+    size_t n;
+    size_t next;             // prochain indice à réclamer (atomique)
+    int busy;                // threads encore sur le lot
+    unsigned long generation;
+    int stop;
+} InferencePool;
+
+/**
+ * Démarre un groupe de threads d'inférence.
+ * @param cbc Base compilée (partagée, doit survivre au groupe).
+ * @param engine Moteur utilisé pour chaque base de faits.
+ * @param workers Nombre de threads (<= 0: nombre de cœurs).
+ * @return Groupe démarré, à libérer avec inference_pool_free.
+ */
+InferencePool *inference_pool_create(const CompiledBC *cbc, InferenceEngine engine, int workers);
+
+/**
+ * Calcule la clôture de n bases de faits en parallèle.
+ * outputs[i] reçoit une copie de inputs[i] complétée des faits déduits
+ * (même ordre que les entrées). Bloque jusqu'à la fin du lot.
+ * @param pool Groupe de threads.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées, à libérer avec facts_free).
+ * @param n Nombre de bases de faits.
+ * @return 1 si succès, 0 si le moteur a rejeté la base (sorties = copies des entrées).
+ */
+int inference_pool_run(InferencePool *pool, const BaseFaits *inputs, BaseFaits *outputs, size_t n);
+
+/**
+ * Arrête les threads et libère le groupe.
+ * @param pool Groupe de threads.
+ * @return Aucun.
+ */
+void inference_pool_free(InferencePool *pool);
+
+/**
+ * Calcule la clôture de n bases de faits avec un groupe temporaire.
+ * @param bc Base de connaissances.
+ * @param inputs n bases de faits initiales (non modifiées).
+ * @param outputs n bases de faits en sortie (créées, à libérer avec facts_free).
+ * @param n Nombre de bases de faits.
+ * @param workers Nombre de threads (<= 0: nombre de cœurs).
+ * @param engine Moteur à utiliser.
+ * @return 1 si succès, 0 si le moteur a rejeté la base.
+ */
+int inference_parallel(const BC *bc, const BaseFaits *inputs, BaseFaits *outputs, size_t n,
+                       int workers, InferenceEngine engine);
@@ -1,4 +1,5 @@
 #pragma once
+#include <stdio.h>
 #include "bc.h"
 
 /**
@@ -9,3 +10,15 @@
  * @return Aucun.
  */
 void bc_print_ascii(const BC *bc);
+
+/**
+ * Écrit le même dessin que bc_print_ascii dans un flux. La disposition
+ * (ligne de chaque entrée et de chaque règle) est calculée une fois, par
+ * identifiant de symbole; chaque ligne est ensuite composée dans un tampon
+ * unique et écrite d'un bloc, pour un coût proportionnel à la taille du
+ * dessin (lignes × colonnes).
+ * @param bc Base de connaissances à afficher.
+ * @param out Flux de sortie.
+ * @return Aucun.
+ */
+void bc_fprint_ascii(const BC *bc, FILE *out);
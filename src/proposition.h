@@ -1,47 +1,66 @@
 #pragma once
 #include <stdlib.h>
 #include <string.h>
+#include "symbol.h"
 
 typedef struct Proposition {
-    char *name;
+    int id;      // identifiant du symbole interné (voir symbol.h)
     int negated; // 0: false, 1: true (represents ¬)
 } Proposition;
 
 /**
- * Crée une proposition.
+ * Crée une proposition à partir d'un nom.
+ * Le nom est interné dans la table des symboles (pas de copie par proposition).
  * @param name Nom de la proposition.
  * @param negated 1 si négation (¬), 0 sinon.
  * @return Proposition initialisée.
  */
 static inline Proposition proposition_make(const char *name, int negated) {
     Proposition p;
-    p.name = (char*)malloc(strlen(name) + 1);
-    strcpy(p.name, name);
+    p.id = symbol_intern(name);
     p.negated = negated ? 1 : 0;
     return p;
 }
 
+/**
+ * Crée une proposition à partir d'un identifiant de symbole déjà interné.
+ * @param id Identifiant du symbole.
+ * @param negated 1 si négation (¬), 0 sinon.
+ * @return Proposition initialisée.
+ */
+static inline Proposition proposition_from_id(int id, int negated) {
+    Proposition p;
+    p.id = id;
+    p.negated = negated ? 1 : 0;
+    return p;
+}
+
+/**
+ * Accède au nom d'une proposition.
+ * @param p Proposition.
+ * @return Nom (possédé par la table des symboles), "" si aucun.
+ */
+static inline const char *proposition_name(const Proposition *p) {
+    return p ? symbol_name(p->id) : "";
+}
+
 /**
  * Libère les ressources d'une proposition.
+ * Les noms appartiennent à la table des symboles: rien à libérer.
  * @param p Proposition à libérer.
  * @return Aucun.
  */
 static inline void proposition_free(Proposition *p) {
-    if (p && p->name) {
-        free(p->name);
-        p->name = NULL;
-    }
+    (void)p;
 }
 
 /**
- * Compare deux propositions (nom et négation).
+ * Compare deux propositions (symbole et négation).
  * @param a Première proposition.
  * @param b Deuxième proposition.
  * @return 1 si égales, 0 sinon.
  */
 static inline int proposition_equals(const Proposition *a, const Proposition *b) {
     if (!a || !b) return 0;
-    if (a->negated != b->negated) return 0;
-    if (!a->name || !b->name) return 0;
-    return strcmp(a->name, b->name) == 0;
+    return a->id == b->id && a->negated == b->negated && a->id != SYMBOL_NONE;
 }
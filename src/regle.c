@@ -6,7 +6,16 @@
  * @return Règle initialisée.
  */
 Regle regle_create() {
-    Regle r; r.premises = listp_create(); r.has_conclusion = 0; r.conclusion = proposition_make("", 0); proposition_free(&r.conclusion); return r;
+    return regle_create_in(NULL);
+}
+
+/**
+ * Crée une règle vide dont les nœuds de prémisse sont alloués dans une arène.
+ * @param arena Arène propriétaire des nœuds (NULL: allocation classique).
+ * @return Règle initialisée.
+ */
+Regle regle_create_in(Arena *arena) {
+    Regle r; r.premises = listp_create_in(arena); r.has_conclusion = 0; r.conclusion = proposition_from_id(SYMBOL_NONE, 0); return r;
 }
 
 /**
@@ -104,7 +113,7 @@ int regle_has_conclusion(const Regle *r) {
  */
 Proposition regle_get_conclusion(const Regle *r) {
     if (!r || !r->has_conclusion) {
-        return proposition_make("", 0);
+        return proposition_from_id(SYMBOL_NONE, 0);
     }
     return r->conclusion;
 }
@@ -13,6 +13,14 @@ typedef struct Regle {
  */
 Regle regle_create();
 
+/**
+ * Crée une règle vide dont les nœuds de prémisse sont alloués dans une arène
+ * (typiquement celle de la base de connaissances qui recevra la règle).
+ * @param arena Arène propriétaire des nœuds (NULL: allocation classique).
+ * @return Règle initialisée.
+ */
+Regle regle_create_in(Arena *arena);
+
 /**
  * Libère une règle (prémisse et conclusion éventuelle).
  * @param r Pointeur vers la règle.
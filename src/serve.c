@@ -0,0 +1,359 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "batch.h"
+#include "serve.h"
+
+// Queries evaluated together: one bit-sliced block
+#define SERVE_CHUNK BATCH_WIDTH
+// Chunks in flight across the pipeline (bounds memory and read-ahead)
+#define SERVE_CHUNKS 8
+// Pending output written once it grows past this, even mid-burst
+#define SERVE_FLUSH (1u << 16)
+#define SERVE_READ (1u << 16)
+
+/**
+ * Lit une base de faits textuelle sans interner de symbole.
+ * @param cbc Base compilée.
+ * @param text Début du texte.
+ * @param len Longueur du texte en octets.
+ * @param out Sortie: littéraux.
+ * @return Nombre de littéraux écrits.
+ */
+size_t serve_parse_facts(const CompiledBC *cbc, const char *text, size_t len, uint32_t *out) {
+    static const char NOT[] = "¬";
+    size_t n = 0, i = 0;
+    while (i < len) {
+        while (i < len && (text[i] == ',' || text[i] == ' ' || text[i] == '\t' || text[i] == '\r')) i++;
+        size_t start = i;
+        while (i < len && text[i] != ',' && text[i] != ' ' && text[i] != '\t' && text[i] != '\r') i++;
+        const char *p = text + start;
+        size_t plen = i - start;
+        int neg = 0;
+        if (plen > 0 && *p == '!') { neg = 1; p++; plen--; }
+        else if (plen >= sizeof(NOT) - 1 && memcmp(p, NOT, sizeof(NOT) - 1) == 0) {
+            neg = 1;
+            p += sizeof(NOT) - 1;
+            plen -= sizeof(NOT) - 1;
+        }
+        if (plen == 0) continue;
+        int id = symbol_lookup_n(p, plen);
+        if (id == SYMBOL_NONE || (uint32_t)id >= cbc->nsyms) continue;
+        out[n++] = LIT_MAKE(id, neg);
+    }
+    return n;
+}
+
+/**
+ * Réserve de la place à la fin d'un tampon.
+ * @param b Tampon.
+ * @param extra Octets à pouvoir ajouter.
+ * @return Aucun.
+ */
+void serve_buffer_reserve(ServeBuffer *b, size_t extra) {
+    if (b->len + extra <= b->cap) return;
+    size_t cap = b->cap ? b->cap : 256;
+    while (cap < b->len + extra) cap *= 2;
+    b->data = (char*)realloc(b->data, cap);
+    b->cap = cap;
+}
+
+/**
+ * Ajoute des littéraux au format texte.
+ * @param b Tampon.
+ * @param lits Littéraux.
+ * @param n Nombre de littéraux.
+ * @return Aucun.
+ */
+void serve_append_facts(ServeBuffer *b, const uint32_t *lits, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        const char *name = symbol_name(LIT_ID(lits[k]));
+        size_t len = strlen(name);
+        serve_buffer_reserve(b, len + 2);
+        if (k) b->data[b->len++] = ',';
+        if (LIT_NEG(lits[k])) b->data[b->len++] = '!';
+        memcpy(b->data + b->len, name, len);
+        b->len += len;
+    }
+}
+
+// A batch of queries on its way through the pipeline
+typedef struct ServeChunk {
+    size_t n;                          // queries in this chunk
+    int last;                          // end of input: the stages stop after it
+    uint32_t *lits;                    // input literals of query i in
+    size_t lits_cap;                   // lits[lit_start[i], lit_start[i+1])
+    uint32_t lit_start[SERVE_CHUNK + 1];
+    uint32_t *out;                     // derived literals, same layout
+    size_t out_cap;
+    uint32_t out_start[SERVE_CHUNK + 1];
+} ServeChunk;
+
+// Bounded FIFO between two stages (capacity: every chunk in flight)
+typedef struct ChunkQueue {
+    ServeChunk *items[SERVE_CHUNKS];
+    size_t head, len;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} ChunkQueue;
+
+static void queue_init(ChunkQueue *q) {
+    q->head = q->len = 0;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->ready, NULL);
+}
+
+static void queue_destroy(ChunkQueue *q) {
+    pthread_cond_destroy(&q->ready);
+    pthread_mutex_destroy(&q->lock);
+}
+
+static void queue_push(ChunkQueue *q, ServeChunk *c) {
+    pthread_mutex_lock(&q->lock);
+    q->items[(q->head + q->len++) % SERVE_CHUNKS] = c;
+    pthread_cond_signal(&q->ready);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static ServeChunk *queue_pop(ChunkQueue *q) {
+    pthread_mutex_lock(&q->lock);
+    while (q->len == 0) pthread_cond_wait(&q->ready, &q->lock);
+    ServeChunk *c = q->items[q->head];
+    q->head = (q->head + 1) % SERVE_CHUNKS;
+    q->len--;
+    pthread_mutex_unlock(&q->lock);
+    return c;
+}
+
+static int queue_empty(ChunkQueue *q) {
+    pthread_mutex_lock(&q->lock);
+    int empty = q->len == 0;
+    pthread_mutex_unlock(&q->lock);
+    return empty;
+}
+
+typedef struct ServePipeline {
+    const CompiledBC *cbc;
+    int in_fd, out_fd;
+    ChunkQueue free_chunks;   // writer -> reader
+    ChunkQueue parsed;        // reader -> inference
+    ChunkQueue done;          // inference -> writer
+    uint64_t queries;
+    int write_failed;
+} ServePipeline;
+
+static void chunk_add_line(const CompiledBC *cbc, ServeChunk *c, const char *line, size_t len) {
+    size_t need = c->lit_start[c->n] + len / 2 + 1;
+    if (need > c->lits_cap) {
+        while (c->lits_cap < need) c->lits_cap = c->lits_cap ? c->lits_cap * 2 : 1024;
+        c->lits = (uint32_t*)realloc(c->lits, c->lits_cap * sizeof(uint32_t));
+    }
+    size_t n = serve_parse_facts(cbc, line, len, c->lits + c->lit_start[c->n]);
+    c->lit_start[c->n + 1] = c->lit_start[c->n] + (uint32_t)n;
+    c->n++;
+}
+
+// Stage 1: splits the input into lines and parses them. Whatever is in the
+// buffer after a read goes out at once, so a lone query is not held back
+// waiting for a full chunk.
+static void *reader_main(void *arg) {
+    ServePipeline *sp = (ServePipeline*)arg;
+    size_t cap = SERVE_READ, len = 0;
+    char *buf = (char*)malloc(cap);
+    ServeChunk *c = queue_pop(&sp->free_chunks);
+    c->n = 0;
+    c->last = 0;
+    c->lit_start[0] = 0;
+    for (;;) {
+        if (len == cap) {
+            // A line longer than the buffer
+            cap *= 2;
+            buf = (char*)realloc(buf, cap);
+        }
+        ssize_t got = read(sp->in_fd, buf + len, cap - len);
+        if (got < 0 && errno == EINTR) continue;
+        int eof = got <= 0;
+        if (!eof) len += (size_t)got;
+        size_t pos = 0;
+        for (;;) {
+            char *nl = (char*)memchr(buf + pos, '\n', len - pos);
+            if (!nl) {
+                // Unterminated last line
+                if (!eof || pos == len) break;
+                nl = buf + len;
+            }
+            chunk_add_line(sp->cbc, c, buf + pos, (size_t)(nl - (buf + pos)));
+            pos = nl - buf < (ptrdiff_t)len ? (size_t)(nl - buf) + 1 : len;
+            if (c->n == SERVE_CHUNK) {
+                queue_push(&sp->parsed, c);
+                c = queue_pop(&sp->free_chunks);
+                c->n = 0;
+                c->last = 0;
+                c->lit_start[0] = 0;
+            }
+        }
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        if (eof) {
+            c->last = 1;
+            queue_push(&sp->parsed, c);
+            break;
+        }
+        if (c->n > 0) {
+            queue_push(&sp->parsed, c);
+            c = queue_pop(&sp->free_chunks);
+            c->n = 0;
+            c->last = 0;
+            c->lit_start[0] = 0;
+        }
+    }
+    free(buf);
+    return NULL;
+}
+
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(fd, data, len);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return 0;
+        data += w;
+        len -= (size_t)w;
+    }
+    return 1;
+}
+
+// Stage 3: formats the answers in query order. Output is written when the
+// pipeline runs dry or the buffer is large; after a write error the chunks
+// keep flowing back so that the other stages can finish.
+static void *writer_main(void *arg) {
+    ServePipeline *sp = (ServePipeline*)arg;
+    ServeBuffer out;
+    memset(&out, 0, sizeof(out));
+    for (;;) {
+        ServeChunk *c = queue_pop(&sp->done);
+        int last = c->last;
+        for (size_t i = 0; i < c->n; ++i) {
+            serve_append_facts(&out, c->out + c->out_start[i], c->out_start[i + 1] - c->out_start[i]);
+            serve_buffer_reserve(&out, 1);
+            out.data[out.len++] = '\n';
+        }
+        sp->queries += c->n;
+        queue_push(&sp->free_chunks, c);
+        if (out.len > 0 && (last || out.len >= SERVE_FLUSH || queue_empty(&sp->done))) {
+            if (!sp->write_failed && !write_all(sp->out_fd, out.data, out.len)) sp->write_failed = 1;
+            out.len = 0;
+        }
+        if (last) break;
+    }
+    free(out.data);
+    return NULL;
+}
+
+// Stage 2: one bit-sliced block per chunk; the firing log, replayed per
+// query, gives each closure's new facts in the naive engine's order.
+static void infer_chunk(BatchBlock *b, ServeChunk *c) {
+    const CompiledBC *cbc = b->cbc;
+    batch_block_clear(b);
+    for (size_t s = 0; s < c->n; ++s) {
+        for (uint32_t k = c->lit_start[s]; k < c->lit_start[s + 1]; ++k) {
+            uint32_t lit = c->lits[k];
+            batch_lane(b, LIT_ID(lit), LIT_NEG(lit))[s >> 6] |= (uint64_t)1 << (s & 63);
+        }
+    }
+    batch_block_run(b);
+
+    uint32_t count[SERVE_CHUNK + 1];
+    memset(count, 0, sizeof(count));
+    for (size_t e = 0; e < b->log_len; ++e) {
+        for (int w = 0; w < BATCH_WORDS; ++w) {
+            uint64_t bits = b->log[e].mask[w];
+            while (bits) {
+                count[(size_t)w * 64 + (size_t)__builtin_ctzll(bits)]++;
+                bits &= bits - 1;
+            }
+        }
+    }
+    c->out_start[0] = 0;
+    for (size_t s = 0; s < c->n; ++s) c->out_start[s + 1] = c->out_start[s] + count[s];
+    if (c->out_start[c->n] > c->out_cap) {
+        c->out_cap = c->out_start[c->n];
+        c->out = (uint32_t*)realloc(c->out, c->out_cap * sizeof(uint32_t));
+    }
+    for (size_t s = 0; s < c->n; ++s) count[s] = c->out_start[s];
+    for (size_t e = 0; e < b->log_len; ++e) {
+        uint32_t concl = cbc->conclusions[b->log[e].rule];
+        for (int w = 0; w < BATCH_WORDS; ++w) {
+            uint64_t bits = b->log[e].mask[w];
+            while (bits) {
+                size_t s = (size_t)w * 64 + (size_t)__builtin_ctzll(bits);
+                bits &= bits - 1;
+                if (s < c->n) c->out[count[s]++] = concl;
+            }
+        }
+    }
+}
+
+/**
+ * Sert des requêtes ligne à ligne sur un flux.
+ * @param cbc Base compilée.
+ * @param in_fd Descripteur d'entrée.
+ * @param out_fd Descripteur de sortie.
+ * @param queries Sortie optionnelle: nombre de requêtes servies.
+ * @return 1 si succès, 0 si erreur d'écriture.
+ */
+int serve_stream(const CompiledBC *cbc, int in_fd, int out_fd, uint64_t *queries) {
+    if (!cbc) return 0;
+    ServePipeline sp;
+    memset(&sp, 0, sizeof(sp));
+    sp.cbc = cbc;
+    sp.in_fd = in_fd;
+    sp.out_fd = out_fd;
+    queue_init(&sp.free_chunks);
+    queue_init(&sp.parsed);
+    queue_init(&sp.done);
+    ServeChunk *chunks = (ServeChunk*)calloc(SERVE_CHUNKS, sizeof(ServeChunk));
+    for (size_t i = 0; i < SERVE_CHUNKS; ++i) queue_push(&sp.free_chunks, &chunks[i]);
+
+    pthread_t reader, writer;
+    int have_reader = pthread_create(&reader, NULL, reader_main, &sp) == 0;
+    int have_writer = have_reader && pthread_create(&writer, NULL, writer_main, &sp) == 0;
+    BatchBlock b = batch_block_create(cbc, 1);
+    if (have_writer) {
+        for (;;) {
+            ServeChunk *c = queue_pop(&sp.parsed);
+            int last = c->last;
+            if (c->n > 0) infer_chunk(&b, c);
+            queue_push(&sp.done, c);
+            if (last) break;
+        }
+        pthread_join(writer, NULL);
+    } else {
+        sp.write_failed = 1;
+    }
+    if (have_reader) {
+        if (!have_writer) {
+            // Without a writer the reader would block: drain it
+            for (;;) {
+                ServeChunk *c = queue_pop(&sp.parsed);
+                int last = c->last;
+                queue_push(&sp.free_chunks, c);
+                if (last) break;
+            }
+        }
+        pthread_join(reader, NULL);
+    }
+    batch_block_free(&b);
+
+    for (size_t i = 0; i < SERVE_CHUNKS; ++i) {
+        free(chunks[i].lits);
+        free(chunks[i].out);
+    }
+    free(chunks);
+    queue_destroy(&sp.done);
+    queue_destroy(&sp.parsed);
+    queue_destroy(&sp.free_chunks);
+    if (queries) *queries = sp.queries;
+    return !sp.write_failed;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "compiled.h"
+
+/**
+ * Lit une base de faits textuelle "A,B,!C" (séparateurs: virgule, espace ou
+ * tabulation; négation '!' ou '¬') sans interner de symbole: les noms
+ * inconnus de la base compilée sont ignorés, car aucune règle ne les lit.
+ * Ne modifie pas la table des symboles (utilisable depuis plusieurs threads).
+ * @param cbc Base compilée.
+ * @param text Début du texte (pas de '\0' requis).
+ * @param len Longueur du texte en octets.
+ * @param out Sortie: littéraux (LIT_MAKE), au plus len / 2 + 1 entrées.
+ * @return Nombre de littéraux écrits.
+ */
+size_t serve_parse_facts(const CompiledBC *cbc, const char *text, size_t len, uint32_t *out);
+
+// Tampon de sortie extensible.
+typedef struct ServeBuffer {
+    char *data;
+    size_t len;
+    size_t cap;
+} ServeBuffer;
+
+/**
+ * Réserve de la place à la fin d'un tampon (croissance géométrique).
+ * @param b Tampon.
+ * @param extra Octets à pouvoir ajouter après b->len.
+ * @return Aucun.
+ */
+void serve_buffer_reserve(ServeBuffer *b, size_t extra);
+
+/**
+ * Ajoute des littéraux au format de serve_parse_facts ("R1,!X"), sans fin
+ * de ligne. Ne lit la table des symboles que pour les noms.
+ * @param b Tampon (initialisé à zéro, à libérer avec free(b->data)).
+ * @param lits Littéraux (LIT_MAKE).
+ * @param n Nombre de littéraux.
+ * @return Aucun.
+ */
+void serve_append_facts(ServeBuffer *b, const uint32_t *lits, size_t n);
+
+/**
+ * Sert des requêtes sur un flux: chaque ligne lue est une base de faits
+ * (voir serve_parse_facts), et reçoit en réponse une ligne avec les faits
+ * déduits, dans l'ordre du moteur naïf, au même format ("R1,!X"; ligne
+ * vide si rien n'est déduit). Les réponses suivent l'ordre des requêtes.
+ * Lecture, inférence et écriture forment un pipeline de trois threads
+ * reliés par des files bornées de lots: les lignes disponibles sont
+ * groupées par lots de BATCH_WIDTH évalués ensemble (moteur par tranches
+ * de bits, voir batch.h), et la sortie est écrite dès que le pipeline se
+ * vide, si bien qu'un client qui attend chaque réponse n'attend pas un lot
+ * plein. La table des symboles n'est que lue pendant le service.
+ * @param cbc Base compilée (partagée en lecture seule).
+ * @param in_fd Descripteur lu jusqu'à la fin de fichier.
+ * @param out_fd Descripteur recevant les réponses.
+ * @param queries Sortie optionnelle: nombre de requêtes servies.
+ * @return 1 si succès, 0 si erreur d'écriture.
+ */
+int serve_stream(const CompiledBC *cbc, int in_fd, int out_fd, uint64_t *queries);
@@ -0,0 +1,589 @@
+// accept4
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "backward.h"
+#include "serve.h"
+#include "server.h"
+#include "stratify.h"
+
+#define SERVER_EVENTS 64
+#define SERVER_READ (1u << 16)
+// Unsent output above which a connection's next request waits
+#define SERVER_OUT_LIMIT (1u << 16)
+// Buffered input above which a connection is no longer read
+#define SERVER_IN_LIMIT (SERVER_HEADER + SERVER_MAX_FRAME)
+
+typedef struct Conn Conn;
+
+// One request on its way to a worker and back
+typedef struct Job {
+    Conn *conn;
+    char *req;
+    size_t len;
+    ServeBuffer resp;
+    struct Job *next;
+} Job;
+
+struct Conn {
+    int fd;
+    ServeBuffer in;          // received bytes; in.data[in_off..] not dispatched yet
+    size_t in_off;
+    ServeBuffer out;         // framed answers; out.data[out_off..] not sent yet
+    size_t out_off;
+    uint32_t events;         // epoll interest currently registered
+    int busy;                // a request of this connection is at a worker
+    int eof;                 // the peer has finished sending
+    int dead;                // closed; freed once no job refers to it
+    Conn *prev, *next;       // every allocated connection
+    Conn *next_dead;         // freed at the end of the current loop turn
+};
+
+typedef struct ServerWorker {
+    struct Server *server;
+    pthread_t thread;
+    AgendaScratch agenda;    // per-thread working state
+    BackwardIndex backward;
+    BaseFaits facts;
+    uint32_t *lits;
+    size_t lits_cap;
+} ServerWorker;
+
+struct Server {
+    const CompiledBC *cbc;
+    InferenceEngine engine;
+    Strata strata;           // precomputed strata (stratified engine)
+    char *path;              // socket to unlink, once bound
+    int listen_fd, epoll_fd, event_fd, signal_fd;
+    sigset_t old_mask;
+    int nworkers;
+    ServerWorker *workers;
+    // Requests waiting for a worker (FIFO)
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    Job *queue_head, *queue_tail;
+    int stop;
+    // Answered requests waiting for the event loop
+    pthread_mutex_t done_lock;
+    Job *done;
+    Conn *conns;
+    Conn *graveyard;
+    uint64_t requests;
+};
+
+static void worker_reserve(ServerWorker *w, size_t n) {
+    if (n <= w->lits_cap) return;
+    w->lits_cap = n > 2 * w->lits_cap ? n : 2 * w->lits_cap;
+    w->lits = (uint32_t*)realloc(w->lits, w->lits_cap * sizeof(uint32_t));
+}
+
+static void add_lits(BaseFaits *bf, const uint32_t *lits, size_t n) {
+    for (size_t k = 0; k < n; ++k) facts_add(bf, proposition_from_id(LIT_ID(lits[k]), LIT_NEG(lits[k])));
+}
+
+static void append_error(ServeBuffer *b, const char *reason) {
+    size_t n = strlen(reason);
+    serve_buffer_reserve(b, 7 + n);
+    memcpy(b->data + b->len, "error: ", 7);
+    memcpy(b->data + b->len + 7, reason, n);
+    b->len += 7 + n;
+}
+
+// Answers one request into job->resp (text only; the loop adds the header)
+static void answer(Server *s, ServerWorker *w, Job *job) {
+    const char *text = job->req;
+    size_t len = job->len;
+    worker_reserve(w, len / 2 + 1);
+    facts_clear(&w->facts);
+    if (len > 0 && text[0] == '?') {
+        // "?GOAL facts": the goal runs up to the first blank
+        size_t end = 1;
+        while (end < len && text[end] != ' ' && text[end] != '\t') end++;
+        size_t ngoal = serve_parse_facts(s->cbc, text + 1, end - 1, w->lits);
+        if (end == 1 || ngoal > 1) {
+            append_error(&job->resp, "expected one goal");
+            return;
+        }
+        uint32_t goal = ngoal == 1 ? w->lits[0] : 0;
+        add_lits(&w->facts, w->lits, serve_parse_facts(s->cbc, text + end, len - end, w->lits));
+        // An unknown goal is simply not provable
+        int proven = ngoal == 1 ?
+                     backward_prove(&w->backward, &w->facts, proposition_from_id(LIT_ID(goal), LIT_NEG(goal))) : 0;
+        if (proven < 0) {
+            append_error(&job->resp, "goal too deep");
+            return;
+        }
+        serve_buffer_reserve(&job->resp, 1);
+        job->resp.data[job->resp.len++] = proven ? '1' : '0';
+        return;
+    }
+    add_lits(&w->facts, w->lits, serve_parse_facts(s->cbc, text, len, w->lits));
+    size_t cursor = w->facts.order_len;
+    switch (s->engine) {
+    case ENGINE_AGENDA: inference_forward_chain_agenda_scratch(s->cbc, &w->facts, &w->agenda); break;
+    case ENGINE_STRATIFIED: strata_forward_chain(s->cbc, &s->strata, &w->facts); break;
+    case ENGINE_NAIVE:
+    default: inference_forward_chain_compiled(s->cbc, &w->facts); break;
+    }
+    // Derived facts follow the request's facts in insertion order
+    size_t n = 0;
+    Proposition p;
+    worker_reserve(w, w->facts.order_len - cursor);
+    while (facts_next(&w->facts, &cursor, &p)) w->lits[n++] = LIT_MAKE(p.id, p.negated);
+    serve_append_facts(&job->resp, w->lits, n);
+}
+
+static void *worker_main(void *arg) {
+    ServerWorker *w = (ServerWorker*)arg;
+    Server *s = w->server;
+    for (;;) {
+        pthread_mutex_lock(&s->lock);
+        while (!s->stop && !s->queue_head) pthread_cond_wait(&s->work, &s->lock);
+        if (s->stop) {
+            pthread_mutex_unlock(&s->lock);
+            break;
+        }
+        Job *job = s->queue_head;
+        s->queue_head = job->next;
+        if (!s->queue_head) s->queue_tail = NULL;
+        pthread_mutex_unlock(&s->lock);
+
+        answer(s, w, job);
+
+        pthread_mutex_lock(&s->done_lock);
+        int wake = s->done == NULL;
+        job->next = s->done;
+        s->done = job;
+        pthread_mutex_unlock(&s->done_lock);
+        // The loop drains the whole list per wakeup: signal the first job only
+        if (wake) {
+            uint64_t one = 1;
+            ssize_t r = write(s->event_fd, &one, sizeof(one));
+            (void)r;
+        }
+    }
+    return NULL;
+}
+
+static void job_free(Job *job) {
+    free(job->req);
+    free(job->resp.data);
+    free(job);
+}
+
+static void conn_free(Server *s, Conn *c) {
+    if (c->prev) c->prev->next = c->next;
+    else s->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+    if (c->fd >= 0) close(c->fd);
+    free(c->in.data);
+    free(c->out.data);
+    free(c);
+}
+
+// Stops watching the connection; the memory outlives the current loop
+// turn (later events of the same batch may still name it) and its job
+static void conn_close(Server *s, Conn *c) {
+    if (c->dead) return;
+    epoll_ctl(s->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    c->dead = 1;
+    if (!c->busy) {
+        c->next_dead = s->graveyard;
+        s->graveyard = c;
+    }
+}
+
+static void conn_flush(Server *s, Conn *c) {
+    while (!c->dead && c->out_off < c->out.len) {
+        ssize_t w = send(c->fd, c->out.data + c->out_off, c->out.len - c->out_off, MSG_NOSIGNAL);
+        if (w > 0) {
+            c->out_off += (size_t)w;
+        } else if (w < 0 && errno == EINTR) {
+            continue;
+        } else if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            conn_close(s, c);
+            return;
+        }
+    }
+    c->out.len = c->out_off = 0;
+}
+
+static void conn_read(Server *s, Conn *c) {
+    if (c->in_off > 0) {
+        // Keep undispatched bytes at the front
+        memmove(c->in.data, c->in.data + c->in_off, c->in.len - c->in_off);
+        c->in.len -= c->in_off;
+        c->in_off = 0;
+    }
+    while (!c->eof && c->in.len < SERVER_IN_LIMIT) {
+        serve_buffer_reserve(&c->in, SERVER_READ);
+        ssize_t r = read(c->fd, c->in.data + c->in.len, c->in.cap - c->in.len);
+        if (r > 0) {
+            c->in.len += (size_t)r;
+        } else if (r == 0) {
+            c->eof = 1;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        } else {
+            conn_close(s, c);
+            return;
+        }
+    }
+}
+
+// Hands the next complete request to the workers, one at a time
+static void conn_dispatch(Server *s, Conn *c) {
+    if (c->dead || c->busy || c->out.len - c->out_off > SERVER_OUT_LIMIT) return;
+    size_t avail = c->in.len - c->in_off;
+    if (avail < SERVER_HEADER) return;
+    const unsigned char *head = (const unsigned char*)c->in.data + c->in_off;
+    uint32_t len = server_frame_length(head);
+    if (len > SERVER_MAX_FRAME) {
+        conn_close(s, c);
+        return;
+    }
+    if (avail < SERVER_HEADER + (size_t)len) return;
+    Job *job = (Job*)calloc(1, sizeof(Job));
+    job->conn = c;
+    job->len = len;
+    job->req = (char*)malloc(len ? len : 1);
+    memcpy(job->req, head + SERVER_HEADER, len);
+    c->in_off += SERVER_HEADER + (size_t)len;
+    c->busy = 1;
+
+    pthread_mutex_lock(&s->lock);
+    if (s->queue_tail) s->queue_tail->next = job;
+    else s->queue_head = job;
+    s->queue_tail = job;
+    pthread_cond_signal(&s->work);
+    pthread_mutex_unlock(&s->lock);
+}
+
+// Registers the events the connection can make progress on, or closes it
+// once the peer is done and every answer is out
+static void conn_update(Server *s, Conn *c) {
+    if (c->dead) return;
+    int pending_out = c->out_off < c->out.len;
+    if (c->eof && !c->busy && !pending_out) {
+        // Whatever is left is an incomplete request
+        conn_close(s, c);
+        return;
+    }
+    uint32_t want = 0;
+    if (!c->eof && c->in.len - c->in_off < SERVER_IN_LIMIT) want |= EPOLLIN;
+    if (pending_out) want |= EPOLLOUT;
+    if (want == c->events) return;
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = want;
+    ev.data.ptr = c;
+    epoll_ctl(s->epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->events = want;
+}
+
+static void accept_all(Server *s) {
+    for (;;) {
+        int fd = accept4(s->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return;
+        }
+        Conn *c = (Conn*)calloc(1, sizeof(Conn));
+        c->fd = fd;
+        c->events = EPOLLIN;
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        if (epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->next = s->conns;
+        if (s->conns) s->conns->prev = c;
+        s->conns = c;
+    }
+}
+
+static void conn_event(Server *s, Conn *c, uint32_t events) {
+    if (c->dead) return;
+    if (events & (EPOLLERR | EPOLLHUP)) {
+        // Both directions are shut: no answer can be delivered
+        conn_close(s, c);
+        return;
+    }
+    if (events & EPOLLIN) conn_read(s, c);
+    if (events & EPOLLOUT) conn_flush(s, c);
+    conn_dispatch(s, c);
+    conn_update(s, c);
+}
+
+static void collect_done(Server *s) {
+    uint64_t count;
+    ssize_t r = read(s->event_fd, &count, sizeof(count));
+    (void)r;
+    pthread_mutex_lock(&s->done_lock);
+    Job *job = s->done;
+    s->done = NULL;
+    pthread_mutex_unlock(&s->done_lock);
+    while (job) {
+        Job *next = job->next;
+        Conn *c = job->conn;
+        c->busy = 0;
+        s->requests++;
+        if (c->dead) {
+            c->next_dead = s->graveyard;
+            s->graveyard = c;
+        } else {
+            serve_buffer_reserve(&c->out, SERVER_HEADER + job->resp.len);
+            server_frame_header((unsigned char*)c->out.data + c->out.len, (uint32_t)job->resp.len);
+            if (job->resp.len) memcpy(c->out.data + c->out.len + SERVER_HEADER, job->resp.data, job->resp.len);
+            c->out.len += SERVER_HEADER + job->resp.len;
+            conn_flush(s, c);
+            conn_dispatch(s, c);
+            conn_update(s, c);
+        }
+        job_free(job);
+        job = next;
+    }
+}
+
+static void bury(Server *s) {
+    while (s->graveyard) {
+        Conn *c = s->graveyard;
+        s->graveyard = c->next_dead;
+        conn_free(s, c);
+    }
+}
+
+// Binds 'path', replacing a socket file nobody listens on any more
+static int bind_path(int fd, const char *path, const char **err) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        *err = "socket path too long";
+        return 0;
+    }
+    strcpy(addr.sun_path, path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) return 1;
+    struct stat st;
+    if (errno != EADDRINUSE || lstat(path, &st) != 0 || !S_ISSOCK(st.st_mode)) {
+        *err = errno == EADDRINUSE ? "path exists and is not a socket" : strerror(errno);
+        return 0;
+    }
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int live = probe >= 0 && connect(probe, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    if (probe >= 0) close(probe);
+    if (live) {
+        *err = "another server is listening on this socket";
+        return 0;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) return 1;
+    *err = strerror(errno);
+    return 0;
+}
+
+static int watch(Server *s, int fd, void *tag) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = tag;
+    return epoll_ctl(s->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/**
+ * Ouvre la socket d'écoute et démarre les threads d'inférence.
+ * @param cbc Base compilée.
+ * @param path Chemin de la socket.
+ * @param engine Moteur utilisé pour les clôtures.
+ * @param workers Nombre de threads d'inférence.
+ * @param err Sortie: message d'erreur.
+ * @return Serveur, ou NULL.
+ */
+Server *server_create(const CompiledBC *cbc, const char *path, InferenceEngine engine, int workers,
+                      const char **err) {
+    const char *dummy;
+    if (!err) err = &dummy;
+    if (!cbc || !path) {
+        *err = "missing knowledge base or socket path";
+        return NULL;
+    }
+    Server *s = (Server*)calloc(1, sizeof(Server));
+    s->cbc = cbc;
+    s->engine = engine;
+    s->listen_fd = s->epoll_fd = s->event_fd = s->signal_fd = -1;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->work, NULL);
+    pthread_mutex_init(&s->done_lock, NULL);
+    // Blocked before any thread starts, so that only the signalfd sees them
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &s->old_mask);
+
+    if (engine == ENGINE_STRATIFIED && !inference_stratify(cbc, &s->strata)) {
+        *err = "knowledge base is not stratifiable (negation in a cycle)";
+        server_free(s);
+        return NULL;
+    }
+    s->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (s->listen_fd < 0) {
+        *err = strerror(errno);
+        server_free(s);
+        return NULL;
+    }
+    if (!bind_path(s->listen_fd, path, err)) {
+        server_free(s);
+        return NULL;
+    }
+    s->path = strdup(path);
+    s->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    s->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    s->signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (listen(s->listen_fd, SOMAXCONN) != 0 || s->epoll_fd < 0 || s->event_fd < 0 || s->signal_fd < 0 ||
+        !watch(s, s->listen_fd, &s->listen_fd) || !watch(s, s->event_fd, &s->event_fd) ||
+        !watch(s, s->signal_fd, &s->signal_fd)) {
+        *err = strerror(errno);
+        server_free(s);
+        return NULL;
+    }
+
+    if (workers <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = n > 0 ? (int)n : 1;
+    }
+    s->workers = (ServerWorker*)calloc((size_t)workers, sizeof(ServerWorker));
+    for (int t = 0; t < workers; ++t) {
+        ServerWorker *w = &s->workers[s->nworkers];
+        w->server = s;
+        if (engine == ENGINE_AGENDA) w->agenda = agenda_scratch_create(cbc);
+        w->backward = backward_index_create(cbc);
+        w->backward.max_depth = SERVER_MAX_GOAL_DEPTH;
+        w->facts = facts_create();
+        facts_reserve(&w->facts, cbc->nsyms);
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            agenda_scratch_free(&w->agenda);
+            backward_index_free(&w->backward);
+            facts_free(&w->facts);
+            break;
+        }
+        s->nworkers++;
+    }
+    if (s->nworkers == 0) {
+        *err = "cannot start inference threads";
+        server_free(s);
+        return NULL;
+    }
+    return s;
+}
+
+/**
+ * Nombre de threads d'inférence démarrés.
+ * @param s Serveur.
+ * @return Nombre de threads.
+ */
+int server_worker_count(const Server *s) {
+    return s ? s->nworkers : 0;
+}
+
+/**
+ * Boucle d'événements jusqu'à SIGINT ou SIGTERM.
+ * @param s Serveur.
+ * @param requests Sortie optionnelle: nombre de requêtes servies.
+ * @return 1 si arrêt sur signal, 0 si erreur.
+ */
+int server_run(Server *s, uint64_t *requests) {
+    if (!s) return 0;
+    struct epoll_event events[SERVER_EVENTS];
+    int ok = 1, stop = 0;
+    while (!stop) {
+        int n = epoll_wait(s->epoll_fd, events, SERVER_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = 0;
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            void *tag = events[i].data.ptr;
+            if (tag == &s->listen_fd) {
+                accept_all(s);
+            } else if (tag == &s->event_fd) {
+                collect_done(s);
+            } else if (tag == &s->signal_fd) {
+                struct signalfd_siginfo info;
+                ssize_t r = read(s->signal_fd, &info, sizeof(info));
+                (void)r;
+                stop = 1;
+            } else {
+                conn_event(s, (Conn*)tag, events[i].events);
+            }
+        }
+        bury(s);
+    }
+    if (requests) *requests = s->requests;
+    return ok;
+}
+
+/**
+ * Arrête les threads et libère le serveur.
+ * @param s Serveur.
+ * @return Aucun.
+ */
+void server_free(Server *s) {
+    if (!s) return;
+    pthread_mutex_lock(&s->lock);
+    s->stop = 1;
+    pthread_cond_broadcast(&s->work);
+    pthread_mutex_unlock(&s->lock);
+    for (int t = 0; t < s->nworkers; ++t) {
+        ServerWorker *w = &s->workers[t];
+        pthread_join(w->thread, NULL);
+        agenda_scratch_free(&w->agenda);
+        backward_index_free(&w->backward);
+        facts_free(&w->facts);
+        free(w->lits);
+    }
+    free(s->workers);
+    // Jobs still queued or unanswered: their connections are freed below
+    for (int list = 0; list < 2; ++list) {
+        Job *job = list == 0 ? s->queue_head : s->done;
+        while (job) {
+            Job *next = job->next;
+            job_free(job);
+            job = next;
+        }
+    }
+    while (s->conns) conn_free(s, s->conns);
+    if (s->listen_fd >= 0) close(s->listen_fd);
+    if (s->path) unlink(s->path);
+    free(s->path);
+    if (s->epoll_fd >= 0) close(s->epoll_fd);
+    if (s->event_fd >= 0) close(s->event_fd);
+    if (s->signal_fd >= 0) close(s->signal_fd);
+    if (s->engine == ENGINE_STRATIFIED) strata_free(&s->strata);
+    pthread_sigmask(SIG_SETMASK, &s->old_mask, NULL);
+    pthread_cond_destroy(&s->work);
+    pthread_mutex_destroy(&s->lock);
+    pthread_mutex_destroy(&s->done_lock);
+    free(s);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+#include "compiled.h"
+#include "inference.h"
+
+// Protocole (--serve-unix): chaque message, dans les deux sens, est une
+// longueur sur SERVER_HEADER octets (gros-boutiste) suivie d'autant
+// d'octets de texte.
+// Requête "A,B,!C" (format de serve_parse_facts): réponse avec les faits
+// déduits au même format ("R1,R3"; vide si rien n'est déduit).
+// Requête "?BUT A,B,!C": réponse "1" si le but est prouvé par chaînage
+// arrière à partir des faits, "0" sinon. Une requête refusée (but absent
+// ou multiple, preuve de plus de SERVER_MAX_GOAL_DEPTH sous-buts imbriqués)
+// reçoit "error: <motif>"; la connexion reste ouverte.
+#define SERVER_HEADER 4
+// Taille maximale d'un message; au-delà, la connexion est fermée.
+#define SERVER_MAX_FRAME (1u << 20)
+// Profondeur maximale d'une preuve de but: borne la pile de chaque thread.
+#define SERVER_MAX_GOAL_DEPTH (1u << 20)
+
+// Serveur d'inférence sur une socket Unix (voir server.c).
+typedef struct Server Server;
+
+/**
+ * Écrit l'en-tête d'un message.
+ * @param header Sortie: SERVER_HEADER octets.
+ * @param len Longueur du texte qui suit.
+ * @return Aucun.
+ */
+static inline void server_frame_header(unsigned char *header, uint32_t len) {
+    header[0] = (unsigned char)(len >> 24);
+    header[1] = (unsigned char)(len >> 16);
+    header[2] = (unsigned char)(len >> 8);
+    header[3] = (unsigned char)len;
+}
+
+/**
+ * Lit la longueur annoncée par un en-tête de message.
+ * @param header SERVER_HEADER octets.
+ * @return Longueur du texte qui suit.
+ */
+static inline uint32_t server_frame_length(const unsigned char *header) {
+    return ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) |
+           ((uint32_t)header[2] << 8) | (uint32_t)header[3];
+}
+
+/**
+ * Ouvre la socket d'écoute et démarre les threads d'inférence. Une socket
+ * laissée par un serveur arrêté est remplacée; une socket active ne l'est
+ * pas. SIGINT et SIGTERM sont bloqués jusqu'à server_free et arrêtent
+ * server_run.
+ * @param cbc Base compilée (partagée en lecture seule, doit survivre au serveur).
+ * @param path Chemin de la socket.
+ * @param engine Moteur utilisé pour les clôtures.
+ * @param workers Nombre de threads d'inférence (<= 0: nombre de cœurs).
+ * @param err Sortie: message d'erreur en cas d'échec.
+ * @return Serveur, à libérer avec server_free, ou NULL en cas d'échec.
+ */
+Server *server_create(const CompiledBC *cbc, const char *path, InferenceEngine engine, int workers,
+                      const char **err);
+
+/**
+ * Nombre de threads d'inférence démarrés.
+ * @param s Serveur.
+ * @return Nombre de threads.
+ */
+int server_worker_count(const Server *s);
+
+/**
+ * Boucle d'événements (epoll) sur le thread appelant: accepte les clients,
+ * découpe les messages et confie chaque requête à un thread d'inférence;
+ * les réponses reviennent par un eventfd et sont écrites sans bloquer.
+ * Une connexion a au plus une requête en calcul: les suivantes attendent
+ * dans son tampon et les réponses suivent l'ordre des requêtes.
+ * Revient à la réception de SIGINT ou SIGTERM.
+ * @param s Serveur.
+ * @param requests Sortie optionnelle: nombre de requêtes servies.
+ * @return 1 si arrêt sur signal, 0 si erreur de la boucle.
+ */
+int server_run(Server *s, uint64_t *requests);
+
+/**
+ * Arrête les threads, ferme les connexions, supprime la socket et
+ * rétablit le masque des signaux.
+ * @param s Serveur.
+ * @return Aucun.
+ */
+void server_free(Server *s);
@@ -0,0 +1,299 @@
+#include <stdlib.h>
+#include <string.h>
+#include "session.h"
+#include "stratify.h"
+
+static void push_int(int **arr, size_t *len, size_t *cap, int v) {
+    if (*len == *cap) {
+        *cap = *cap ? *cap * 2 : 64;
+        *arr = (int*)realloc(*arr, *cap * sizeof(int));
+    }
+    (*arr)[(*len)++] = v;
+}
+
+static Proposition key_fact(int key) {
+    return proposition_from_id(key >> 1, key & 1);
+}
+
+static int key_true(const InferenceSession *s, int key) {
+    return facts_has(&s->facts, key >> 1, key & 1);
+}
+
+static int key_base(const InferenceSession *s, int key) {
+    return facts_has(&s->base, key >> 1, key & 1);
+}
+
+// Remember the value a fact had before the current update
+static void touch(InferenceSession *s, int key) {
+    if (s->orig[key] >= 0) return;
+    s->orig[key] = (signed char)key_true(s, key);
+    push_int(&s->touched, &s->touched_len, &s->touched_cap, key);
+}
+
+static void activate(InferenceSession *s, uint32_t r) {
+    int c = (int)s->cbc.conclusions[r];
+    s->support[c]++;
+    if (!key_true(s, c)) push_int(&s->add_queue, &s->add_len, &s->add_cap, c);
+}
+
+static void deactivate(InferenceSession *s, uint32_t r) {
+    int c = (int)s->cbc.conclusions[r];
+    s->support[c]--;
+    if (!key_true(s, c) || key_base(s, c)) return;
+    // Outside recursive strata the count is exact; inside them the remaining
+    // support may be circular, so overdelete and let rederivation decide.
+    if (s->support[c] == 0 || s->cyclic[c]) push_int(&s->del_queue, &s->del_len, &s->del_cap, c);
+}
+
+static void set_true(InferenceSession *s, int key) {
+    touch(s, key);
+    facts_add(&s->facts, key_fact(key));
+    if (key & 1) return; // premises only read the positive plane
+    const CompiledBC *cbc = &s->cbc;
+    int id = key >> 1;
+    for (uint32_t k = cbc->pos_start[id]; k < cbc->pos_start[id + 1]; ++k) {
+        uint32_t r = cbc->pos_rules[k];
+        if (--s->unsat[r] == 0) activate(s, r);
+    }
+    for (uint32_t k = cbc->neg_start[id]; k < cbc->neg_start[id + 1]; ++k) {
+        uint32_t r = cbc->neg_rules[k];
+        if (s->unsat[r]++ == 0) deactivate(s, r);
+    }
+}
+
+static void set_false(InferenceSession *s, int key) {
+    touch(s, key);
+    Proposition p = key_fact(key);
+    facts_remove(&s->facts, &p);
+    if (key & 1) return;
+    const CompiledBC *cbc = &s->cbc;
+    int id = key >> 1;
+    for (uint32_t k = cbc->pos_start[id]; k < cbc->pos_start[id + 1]; ++k) {
+        uint32_t r = cbc->pos_rules[k];
+        if (s->unsat[r]++ == 0) deactivate(s, r);
+    }
+    for (uint32_t k = cbc->neg_start[id]; k < cbc->neg_start[id + 1]; ++k) {
+        uint32_t r = cbc->neg_rules[k];
+        if (--s->unsat[r] == 0) activate(s, r);
+    }
+}
+
+/*
+ * Runs the queues to quiescence. Deletions are handled first (overdelete),
+ * then every overdeleted fact that still has an active rule or is a base
+ * fact is rederived, then pending additions are applied one at a time so
+ * that deletions they trigger through ¬X premises are processed promptly.
+ */
+static void propagate(InferenceSession *s) {
+    while (s->add_len || s->del_len) {
+        while (s->del_len) {
+            int k = s->del_queue[--s->del_len];
+            if (!key_true(s, k) || key_base(s, k)) continue;
+            set_false(s, k);
+            push_int(&s->redo, &s->redo_len, &s->redo_cap, k);
+        }
+        for (size_t i = 0; i < s->redo_len; ++i) {
+            int k = s->redo[i];
+            if (!key_true(s, k) && s->support[k] > 0) push_int(&s->add_queue, &s->add_len, &s->add_cap, k);
+        }
+        s->redo_len = 0;
+        while (s->add_len && !s->del_len) {
+            int k = s->add_queue[--s->add_len];
+            if (key_true(s, k) || (s->support[k] == 0 && !key_base(s, k))) continue;
+            set_true(s, k);
+        }
+    }
+}
+
+// Emit the net changes of the current update and reset the tracking
+static size_t collect_changes(InferenceSession *s, FactChanges *out) {
+    size_t n = 0;
+    for (size_t i = 0; i < s->touched_len; ++i) {
+        int k = s->touched[i];
+        int now = key_true(s, k);
+        if (now != s->orig[k]) {
+            if (out) {
+                if (out->size == out->cap) {
+                    out->cap = out->cap ? out->cap * 2 : 16;
+                    out->items = (FactChange*)realloc(out->items, out->cap * sizeof(FactChange));
+                }
+                out->items[out->size].fact = key_fact(k);
+                out->items[out->size].now_true = now;
+                out->size++;
+            }
+            n++;
+        }
+        s->orig[k] = -1;
+    }
+    s->touched_len = 0;
+    return n;
+}
+
+static void append_change(FactChanges *out, Proposition p, int now_true) {
+    if (!out) return;
+    if (out->size == out->cap) {
+        out->cap = out->cap ? out->cap * 2 : 16;
+        out->items = (FactChange*)realloc(out->items, out->cap * sizeof(FactChange));
+    }
+    out->items[out->size].fact = p;
+    out->items[out->size].now_true = now_true;
+    out->size++;
+}
+
+// Fallback for non-stratifiable bases: recompute and diff.
+static size_t recompute(InferenceSession *s, FactChanges *out) {
+    BaseFaits next = facts_copy(&s->base);
+    inference_forward_chain_compiled(&s->cbc, &next);
+    size_t n = 0, it = 0;
+    Proposition p;
+    while (facts_next(&s->facts, &it, &p)) {
+        if (!facts_contains(&next, &p)) { append_change(out, p, 0); n++; }
+    }
+    it = 0;
+    while (facts_next(&next, &it, &p)) {
+        if (!facts_contains(&s->facts, &p)) { append_change(out, p, 1); n++; }
+    }
+    facts_free(&s->facts);
+    s->facts = next;
+    return n;
+}
+
+/**
+ * Crée une session d'inférence et calcule la clôture initiale.
+ * @param bc Base de connaissances (non modifiée, doit survivre à la session).
+ * @param initial Faits de base initiaux (copiés), peut être NULL.
+ * @return Session initialisée, à libérer avec session_free.
+ */
+InferenceSession session_create(const BC *bc, const BaseFaits *initial) {
+    return session_create_compiled(bc_compile(bc), initial);
+}
+
+/**
+ * Crée une session sur une base déjà compilée, que la session adopte.
+ * @param cbc Base compilée (libérée par session_free).
+ * @param initial Faits de base initiaux (copiés), peut être NULL.
+ * @return Session initialisée, à libérer avec session_free.
+ */
+InferenceSession session_create_compiled(CompiledBC cbc, const BaseFaits *initial) {
+    InferenceSession s;
+    memset(&s, 0, sizeof(s));
+    s.cbc = cbc;
+    s.base = initial ? facts_copy(initial) : facts_create();
+    s.facts = facts_create();
+    // Sized from the compiled base: the global symbol table may be growing
+    // on another thread
+    facts_reserve(&s.base, s.cbc.nsyms);
+    facts_reserve(&s.facts, s.cbc.nsyms);
+
+    Strata st;
+    s.incremental = inference_stratify(&s.cbc, &st);
+    if (!s.incremental) {
+        strata_free(&st);
+        recompute(&s, NULL);
+        return s;
+    }
+
+    size_t nrules = s.cbc.nrules;
+    s.nkeys = 2 * (size_t)s.cbc.nsyms;
+    s.unsat = (int*)malloc((nrules ? nrules : 1) * sizeof(int));
+    s.support = (int*)calloc(s.nkeys ? s.nkeys : 1, sizeof(int));
+    s.cyclic = (unsigned char*)calloc(s.nkeys ? s.nkeys : 1, 1);
+    s.orig = (signed char*)malloc(s.nkeys ? s.nkeys : 1);
+    memset(s.orig, -1, s.nkeys ? s.nkeys : 1);
+
+    for (size_t i = 0; i < nrules; ++i) s.unsat[i] = (int)s.cbc.rules[i].npos;
+    for (size_t k = 0; k < st.count; ++k) {
+        if (!st.cyclic[k]) continue;
+        for (size_t i = st.start[k]; i < st.start[k + 1]; ++i) s.cyclic[s.cbc.conclusions[st.rules[i]]] = 1;
+    }
+    strata_free(&st);
+
+    // Rules without positive premises hold until some ¬X premise fails
+    for (uint32_t i = 0; i < s.cbc.nrules; ++i) if (s.unsat[i] == 0) activate(&s, i);
+    size_t it = 0;
+    Proposition p;
+    while (facts_next(&s.base, &it, &p)) {
+        int key = 2 * p.id + p.negated;
+        if ((size_t)key < s.nkeys) push_int(&s.add_queue, &s.add_len, &s.add_cap, key);
+        else facts_add(&s.facts, p);
+    }
+    propagate(&s);
+    collect_changes(&s, NULL);
+    return s;
+}
+
+/**
+ * Libère une session d'inférence.
+ * @param s Session à libérer.
+ * @return Aucun.
+ */
+void session_free(InferenceSession *s) {
+    if (!s) return;
+    facts_free(&s->base);
+    facts_free(&s->facts);
+    compiled_free(&s->cbc);
+    free(s->unsat);
+    free(s->support); free(s->cyclic);
+    free(s->add_queue); free(s->del_queue); free(s->redo);
+    free(s->orig); free(s->touched);
+    memset(s, 0, sizeof(*s));
+}
+
+/**
+ * Affirme un fait de base et propage uniquement le delta.
+ * @param s Session.
+ * @param p Fait à affirmer.
+ * @param out Sortie optionnelle: changements de la clôture (ajoutés en fin).
+ * @return Nombre de faits dont la valeur a changé.
+ */
+size_t session_assert(InferenceSession *s, Proposition p, FactChanges *out) {
+    if (!s || p.id == SYMBOL_NONE || facts_contains(&s->base, &p)) return 0;
+    facts_add(&s->base, p);
+    if (!s->incremental) return recompute(s, out);
+    int key = 2 * p.id + p.negated;
+    if ((size_t)key >= s->nkeys) {
+        // Symbol unknown to the rules: nothing depends on it
+        if (facts_contains(&s->facts, &p)) return 0;
+        facts_add(&s->facts, p);
+        append_change(out, p, 1);
+        return 1;
+    }
+    push_int(&s->add_queue, &s->add_len, &s->add_cap, key);
+    propagate(s);
+    return collect_changes(s, out);
+}
+
+/**
+ * Retire un fait de base (approche DRed).
+ * @param s Session.
+ * @param p Fait à retirer.
+ * @param out Sortie optionnelle: changements de la clôture (ajoutés en fin).
+ * @return Nombre de faits dont la valeur a changé.
+ */
+size_t session_retract(InferenceSession *s, Proposition p, FactChanges *out) {
+    if (!s || !facts_remove(&s->base, &p)) return 0;
+    if (!s->incremental) return recompute(s, out);
+    int key = 2 * p.id + p.negated;
+    if ((size_t)key >= s->nkeys) {
+        facts_remove(&s->facts, &p);
+        append_change(out, p, 0);
+        return 1;
+    }
+    if (s->support[key] == 0 || s->cyclic[key]) {
+        push_int(&s->del_queue, &s->del_len, &s->del_cap, key);
+        propagate(s);
+    }
+    return collect_changes(s, out);
+}
+
+/**
+ * Libère une liste de changements.
+ * @param c Liste à libérer.
+ * @return Aucun.
+ */
+void changes_free(FactChanges *c) {
+    if (!c) return;
+    free(c->items);
+    c->items = NULL;
+    c->size = c->cap = 0;
+}
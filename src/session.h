@@ -0,0 +1,87 @@
+#pragma once
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+
+// Changement d'un fait suite à une mise à jour incrémentale.
+typedef struct FactChange {
+    Proposition fact;
+    int now_true;   // 1: fait apparu, 0: fait retiré
+} FactChange;
+
+typedef struct FactChanges {
+    FactChange *items;
+    size_t size;
+    size_t cap;
+} FactChanges;
+
+// Session d'inférence: maintient la clôture d'une base de faits initiale
+// et la met à jour par deltas lorsque des faits sont ajoutés ou retirés.
+// La session travaille sur sa propre compilation de la base: celle-ci peut
+// être modifiée ensuite, mais la session doit alors être recréée.
+typedef struct InferenceSession {
+    CompiledBC cbc;        // règles et index inversés (voir compiled.h)
+    BaseFaits base;        // faits affirmés par l'utilisateur
+    BaseFaits facts;       // clôture courante (faits de base + déduits)
+    int incremental;       // 0: base non stratifiable, recalcul complet
+    size_t nkeys;          // 2 * nombre de symboles compilés (clé: 2*id + negated)
+    int *unsat;            // règle -> nombre de prémisses non satisfaites
+    int *support;          // clé -> nombre de règles actives la concluant
+    unsigned char *cyclic; // clé -> conclusion d'une strate récursive
+    // Files de travail et suivi des changements (réutilisés entre appels)
+    int *add_queue; size_t add_len, add_cap;
+    int *del_queue; size_t del_len, del_cap;
+    int *redo;      size_t redo_len, redo_cap;
+    signed char *orig;     // clé -> valeur avant l'appel (-1: non touchée)
+    int *touched;   size_t touched_len, touched_cap;
+} InferenceSession;
+
+/**
+ * Crée une session d'inférence et calcule la clôture initiale.
+ * @param bc Base de connaissances (compilée: la session n'en garde pas de référence).
+ * @param initial Faits de base initiaux (copiés), peut être NULL.
+ * @return Session initialisée, à libérer avec session_free.
+ */
+InferenceSession session_create(const BC *bc, const BaseFaits *initial);
+
+/**
+ * Crée une session sur une base déjà compilée (par exemple sur un autre
+ * thread que celui qui édite la BC). La session adopte la base compilée.
+ * @param cbc Base compilée (libérée par session_free).
+ * @param initial Faits de base initiaux (copiés), peut être NULL.
+ * @return Session initialisée, à libérer avec session_free.
+ */
+InferenceSession session_create_compiled(CompiledBC cbc, const BaseFaits *initial);
+
+/**
+ * Libère une session d'inférence.
+ * @param s Session à libérer.
+ * @return Aucun.
+ */
+void session_free(InferenceSession *s);
+
+/**
+ * Affirme un fait de base et propage uniquement le delta.
+ * @param s Session.
+ * @param p Fait à affirmer.
+ * @param out Sortie optionnelle: changements de la clôture (ajoutés en fin).
+ * @return Nombre de faits dont la valeur a changé.
+ */
+size_t session_assert(InferenceSession *s, Proposition p, FactChanges *out);
+
+/**
+ * Retire un fait de base. Les faits qui en dépendaient sont sur-supprimés
+ * puis re-dérivés s'ils ont un autre support (approche DRed).
+ * @param s Session.
+ * @param p Fait à retirer.
+ * @param out Sortie optionnelle: changements de la clôture (ajoutés en fin).
+ * @return Nombre de faits dont la valeur a changé.
+ */
+size_t session_retract(InferenceSession *s, Proposition p, FactChanges *out);
+
+/**
+ * Libère une liste de changements.
+ * @param c Liste à libérer.
+ * @return Aucun.
+ */
+void changes_free(FactChanges *c);
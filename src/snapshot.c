@@ -0,0 +1,197 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "snapshot.h"
+#include "symbol.h"
+
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+static size_t pad8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+// Word-wise FNV-1a over 8-byte aligned sections
+static uint64_t checksum_update(uint64_t h, const void *data, size_t size) {
+    const unsigned char *p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static int set_error(const char **err, const char *msg) {
+    if (err) *err = msg;
+    return 0;
+}
+
+static size_t slot_table_cap(uint32_t nsyms) {
+    size_t cap = 16;
+    while (cap < 2 * (size_t)nsyms + 1) cap <<= 1;
+    return cap;
+}
+
+/**
+ * Écrit un instantané d'une base compilée et de la table des symboles.
+ * @param cbc Base compilée.
+ * @param path Chemin du fichier à créer.
+ * @param err Sortie optionnelle: message d'erreur.
+ * @return 1 si succès, 0 sinon.
+ */
+int snapshot_save(const CompiledBC *cbc, const char *path, const char **err) {
+    if (!cbc || !path) return set_error(err, "invalid arguments");
+    if (cbc->nsyms > (uint32_t)symbol_count()) return set_error(err, "symbol table does not match the compiled base");
+    uint32_t nsyms = cbc->nsyms;
+
+    // Names, their offsets and a hash table laid out like the live one
+    size_t offsets_size = pad8(((size_t)nsyms + 1) * sizeof(uint32_t));
+    uint32_t *offsets = (uint32_t*)calloc(1, offsets_size);
+    size_t names_len = 0;
+    for (uint32_t i = 0; i < nsyms; ++i) {
+        offsets[i] = (uint32_t)names_len;
+        names_len += strlen(symbol_name((int)i)) + 1;
+    }
+    offsets[nsyms] = (uint32_t)names_len;
+    size_t names_size = pad8(names_len);
+    char *names = (char*)calloc(1, names_size ? names_size : 1);
+    size_t slot_cap = slot_table_cap(nsyms);
+    SymbolSlot *slots = (SymbolSlot*)calloc(slot_cap, sizeof(SymbolSlot));
+    for (uint32_t i = 0; i < nsyms; ++i) {
+        const char *name = symbol_name((int)i);
+        size_t len = offsets[i + 1] - offsets[i] - 1;
+        memcpy(names + offsets[i], name, len);
+        uint32_t h = symbol_hash(name, len);
+        size_t s = h & (slot_cap - 1);
+        while (slots[s].id) s = (s + 1) & (slot_cap - 1);
+        slots[s].hash = h;
+        slots[s].id = (int)i + 1;
+    }
+
+    SnapshotHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic));
+    hdr.version = SNAPSHOT_VERSION;
+    hdr.byte_order = SNAPSHOT_BYTE_ORDER;
+    hdr.nsyms = nsyms;
+    hdr.nrules = cbc->nrules;
+    hdr.npremises = cbc->npremises;
+    hdr.slot_cap = slot_cap;
+    hdr.names_size = names_size;
+    hdr.block_size = compiled_storage_size(cbc->nrules, cbc->nsyms, cbc->npremises);
+    // A view (storage NULL) starts at its rule headers, like an owned block
+    const void *block = cbc->storage ? cbc->storage : (const void*)cbc->rules;
+    uint64_t h = 14695981039346656037ull;
+    h = checksum_update(h, offsets, offsets_size);
+    h = checksum_update(h, slots, slot_cap * sizeof(SymbolSlot));
+    h = checksum_update(h, names, names_size);
+    h = checksum_update(h, block, hdr.block_size);
+    hdr.checksum = h;
+
+    int ok = 0;
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        set_error(err, "cannot open file for writing");
+    } else {
+        ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1
+          && fwrite(offsets, 1, offsets_size, f) == offsets_size
+          && fwrite(slots, sizeof(SymbolSlot), slot_cap, f) == slot_cap
+          && fwrite(names, 1, names_size, f) == names_size
+          && fwrite(block, 1, hdr.block_size, f) == hdr.block_size;
+        if (fclose(f) != 0) ok = 0;
+        if (!ok) set_error(err, "write error");
+    }
+    free(slots);
+    free(names);
+    free(offsets);
+    return ok;
+}
+
+/**
+ * Projette un instantané en mémoire et l'adopte.
+ * @param snap Sortie: instantané ouvert.
+ * @param path Chemin du fichier.
+ * @param err Sortie optionnelle: message d'erreur.
+ * @return 1 si succès, 0 sinon.
+ */
+int snapshot_open(Snapshot *snap, const char *path, const char **err) {
+    if (!snap || !path) return set_error(err, "invalid arguments");
+    memset(snap, 0, sizeof(*snap));
+    if (symbol_count() != 0) return set_error(err, "symbol table already in use");
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return set_error(err, "cannot open file");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        close(fd);
+        return set_error(err, "not a snapshot");
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return set_error(err, "cannot map file");
+
+    const SnapshotHeader *hdr = (const SnapshotHeader*)map;
+    const char *msg = NULL;
+    if (memcmp(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic)) != 0) msg = "not a snapshot";
+    else if (hdr->byte_order != SNAPSHOT_BYTE_ORDER) msg = "snapshot written with another byte order";
+    else if (hdr->version != SNAPSHOT_VERSION) msg = "unsupported snapshot version";
+    if (msg) {
+        munmap(map, size);
+        return set_error(err, msg);
+    }
+
+    size_t offsets_size = pad8(((size_t)hdr->nsyms + 1) * sizeof(uint32_t));
+    uint64_t expected = sizeof(SnapshotHeader) + (uint64_t)offsets_size
+                      + hdr->slot_cap * sizeof(SymbolSlot) + hdr->names_size + hdr->block_size;
+    if (hdr->slot_cap > size || hdr->names_size > size || hdr->block_size > size || expected != size) {
+        munmap(map, size);
+        return set_error(err, "truncated or oversized snapshot");
+    }
+    const char *base = (const char*)map + sizeof(SnapshotHeader);
+    if (checksum_update(14695981039346656037ull, base, size - sizeof(SnapshotHeader)) != hdr->checksum) {
+        munmap(map, size);
+        return set_error(err, "checksum mismatch (stale or corrupted snapshot)");
+    }
+
+    const uint32_t *offsets = (const uint32_t*)base;
+    const SymbolSlot *slots = (const SymbolSlot*)(base + offsets_size);
+    const char *names = (const char*)(slots + hdr->slot_cap);
+    const void *block = names + hdr->names_size;
+    CompiledBC view;
+    if (offsets[hdr->nsyms] > hdr->names_size
+        || !compiled_view(&view, block, hdr->block_size, hdr->nrules, hdr->nsyms, hdr->npremises)) {
+        munmap(map, size);
+        return set_error(err, "inconsistent snapshot");
+    }
+    SymbolImage img;
+    img.count = (int)hdr->nsyms;
+    img.offsets = offsets;
+    img.names = names;
+    img.slots = slots;
+    img.slot_cap = (size_t)hdr->slot_cap;
+    if (!symbols_attach(&img)) {
+        munmap(map, size);
+        return set_error(err, "invalid symbol table");
+    }
+    snap->map = map;
+    snap->map_size = size;
+    snap->cbc = view;
+    return 1;
+}
+
+/**
+ * Ferme un instantané et réinitialise la table des symboles.
+ * @param snap Instantané.
+ * @return Aucun.
+ */
+void snapshot_close(Snapshot *snap) {
+    if (!snap || !snap->map) return;
+    symbols_reset();
+    munmap(snap->map, snap->map_size);
+    memset(snap, 0, sizeof(*snap));
+}
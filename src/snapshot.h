@@ -0,0 +1,62 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "compiled.h"
+
+#define SNAPSHOT_MAGIC "SXKBSNAP"
+#define SNAPSHOT_VERSION 1u
+
+// En-tête d'un instantané. Suivent, alignés sur 8 octets: les décalages des
+// noms (nsyms + 1 uint32), la table de hachage des noms (slot_cap
+// SymbolSlot), les noms ('\0' final compris), puis le bloc de stockage de
+// la base compilée tel quel (voir compiled_view).
+typedef struct SnapshotHeader {
+    char magic[8];        // SNAPSHOT_MAGIC, sans '\0'
+    uint32_t version;     // SNAPSHOT_VERSION
+    uint32_t byte_order;  // 0x01020304 dans l'ordre de l'écrivain
+    uint32_t nsyms;
+    uint32_t nrules;
+    uint32_t npremises;
+    uint32_t reserved;
+    uint64_t slot_cap;
+    uint64_t names_size;  // octets des noms, bourrage compris
+    uint64_t block_size;  // octets du bloc de la base compilée
+    uint64_t checksum;    // somme de contrôle de tout ce qui suit l'en-tête
+} SnapshotHeader;
+
+// Instantané projeté en mémoire, en lecture seule.
+typedef struct Snapshot {
+    void *map;
+    size_t map_size;
+    CompiledBC cbc;       // vue sur la projection (aucune copie)
+} Snapshot;
+
+/**
+ * Écrit un instantané d'une base compilée et de la table des symboles.
+ * @param cbc Base compilée (ses symboles sont les nsyms premiers de la table).
+ * @param path Chemin du fichier à créer.
+ * @param err Sortie optionnelle: message d'erreur.
+ * @return 1 si succès, 0 sinon.
+ */
+int snapshot_save(const CompiledBC *cbc, const char *path, const char **err);
+
+/**
+ * Projette un instantané en mémoire et l'adopte: la table des symboles
+ * (qui doit être vide) référence directement les noms de la projection et
+ * snap->cbc se lit sans désérialisation. Un fichier d'une autre version,
+ * d'un autre boutisme ou dont la somme de contrôle ne correspond pas est
+ * rejeté.
+ * @param snap Sortie: instantané ouvert.
+ * @param path Chemin du fichier.
+ * @param err Sortie optionnelle: message d'erreur.
+ * @return 1 si succès, 0 sinon.
+ */
+int snapshot_open(Snapshot *snap, const char *path, const char **err);
+
+/**
+ * Ferme un instantané. Les noms vivant dans la projection, la table des
+ * symboles est réinitialisée (symbols_reset).
+ * @param snap Instantané.
+ * @return Aucun.
+ */
+void snapshot_close(Snapshot *snap);
@@ -0,0 +1,57 @@
+#include <string.h>
+#include <time.h>
+#include "stats.h"
+
+/**
+ * Remet les compteurs à zéro.
+ * @param st Statistiques.
+ * @return Aucun.
+ */
+void stats_reset(InferenceStats *st) {
+    if (st) memset(st, 0, sizeof(*st));
+}
+
+/**
+ * Horloge monotone pour la mesure des phases.
+ * @return Temps en secondes depuis une origine arbitraire.
+ */
+double stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Ajoute au temps d'une phase la durée écoulée depuis start.
+ * @param st Statistiques (NULL: rien).
+ * @param phase Phase mesurée.
+ * @param start Valeur de stats_now() au début de la phase.
+ * @return Aucun.
+ */
+void stats_add_time(InferenceStats *st, StatsPhase phase, double start) {
+    if (!st || (int)phase < 0 || phase >= STATS_PHASE_COUNT) return;
+    st->seconds[phase] += stats_now() - start;
+}
+
+/**
+ * Affiche les statistiques.
+ * @param st Statistiques.
+ * @param out Flux de sortie.
+ * @return Aucun.
+ */
+void stats_print(const InferenceStats *st, FILE *out) {
+    if (!st || !out) return;
+    fprintf(out, "Statistiques d'inférence:\n");
+    if (!SYS_EXPERT_STATS) {
+        fprintf(out, " (compteurs désactivés à la compilation: SYS_EXPERT_STATS=OFF)\n");
+        return;
+    }
+    fprintf(out, " - passes:                 %llu\n", (unsigned long long)st->passes);
+    fprintf(out, " - évaluations de règles:  %llu\n", (unsigned long long)st->rule_evaluations);
+    fprintf(out, " - tests de prémisses:     %llu\n", (unsigned long long)st->premise_checks);
+    fprintf(out, " - règles déclenchées:     %llu\n", (unsigned long long)st->rules_fired);
+    fprintf(out, " - faits déduits:          %llu\n", (unsigned long long)st->facts_derived);
+    fprintf(out, " - temps compilation:      %.3f ms\n", st->seconds[STATS_PHASE_COMPILE] * 1e3);
+    fprintf(out, " - temps préparation:      %.3f ms\n", st->seconds[STATS_PHASE_PREPARE] * 1e3);
+    fprintf(out, " - temps inférence:        %.3f ms\n", st->seconds[STATS_PHASE_INFER] * 1e3);
+}
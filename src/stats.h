@@ -0,0 +1,85 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+// Instrumentation des moteurs. Avec SYS_EXPERT_STATS à 0 (option CMake
+// SYS_EXPERT_STATS=OFF), les compteurs disparaissent à la compilation: les
+// boucles des moteurs sont identiques à une version sans instrumentation et
+// les fonctions *_stats laissent la structure à zéro.
+#ifndef SYS_EXPERT_STATS
+#define SYS_EXPERT_STATS 1
+#endif
+
+#if SYS_EXPERT_STATS
+#define STATS_ONLY(stmt) stmt
+#else
+#define STATS_ONLY(stmt)
+#endif
+
+// Phases mesurées (temps mural).
+typedef enum StatsPhase {
+    STATS_PHASE_COMPILE = 0, // bc_compile
+    STATS_PHASE_PREPARE,     // strates, état de travail de l'agenda
+    STATS_PHASE_INFER,       // chaînage proprement dit
+    STATS_PHASE_COUNT
+} StatsPhase;
+
+// Compteurs d'une ou plusieurs inférences (les appels successifs cumulent).
+// Tous les moteurs suivent les mêmes conventions: une règle dont la
+// conclusion est déjà connue est écartée sans tester ses prémisses, et les
+// prémisses positives sont testées avant les négées, comme dans bc_compile.
+typedef struct InferenceStats {
+    uint64_t passes;           // tours de la boucle "tant que changement" (somme sur les strates, 0 pour l'agenda)
+    uint64_t rule_evaluations; // règles examinées
+    uint64_t premise_checks;   // littéraux de prémisses testés (agenda: décréments de compteurs compris)
+    uint64_t rules_fired;      // règles dont les prémisses étaient satisfaites (conclusion encore inconnue)
+    uint64_t facts_derived;    // faits ajoutés à la base
+    double seconds[STATS_PHASE_COUNT];
+} InferenceStats;
+
+/**
+ * Remet les compteurs à zéro.
+ * @param st Statistiques.
+ * @return Aucun.
+ */
+void stats_reset(InferenceStats *st);
+
+/**
+ * Ajoute des compteurs à d'autres (les temps de phase compris). En ligne pour
+ * que les compteurs locaux des moteurs restent dans des registres.
+ * @param into Statistiques cumulées (NULL: rien).
+ * @param counts Compteurs à ajouter.
+ * @return Aucun.
+ */
+static inline void stats_merge(InferenceStats *into, const InferenceStats *counts) {
+    if (!into || !counts) return;
+    into->passes += counts->passes;
+    into->rule_evaluations += counts->rule_evaluations;
+    into->premise_checks += counts->premise_checks;
+    into->rules_fired += counts->rules_fired;
+    into->facts_derived += counts->facts_derived;
+    for (int k = 0; k < STATS_PHASE_COUNT; ++k) into->seconds[k] += counts->seconds[k];
+}
+
+/**
+ * Horloge monotone pour la mesure des phases.
+ * @return Temps en secondes depuis une origine arbitraire.
+ */
+double stats_now(void);
+
+/**
+ * Ajoute au temps d'une phase la durée écoulée depuis start.
+ * @param st Statistiques (NULL: rien).
+ * @param phase Phase mesurée.
+ * @param start Valeur de stats_now() au début de la phase.
+ * @return Aucun.
+ */
+void stats_add_time(InferenceStats *st, StatsPhase phase, double start);
+
+/**
+ * Affiche les statistiques.
+ * @param st Statistiques.
+ * @param out Flux de sortie.
+ * @return Aucun.
+ */
+void stats_print(const InferenceStats *st, FILE *out);
@@ -0,0 +1,238 @@
+#include <stdlib.h>
+#include <string.h>
+#include "stratify.h"
+
+typedef struct TarjanFrame {
+    uint32_t v;
+    uint32_t edge;   // cursor over positive then negated occurrences of v
+} TarjanFrame;
+
+// Edges of the dependency graph go from a premise symbol to the conclusion
+// symbol of each rule using it; they are read straight from the inverted
+// indexes of the compiled base.
+static uint32_t out_degree(const CompiledBC *cbc, uint32_t v) {
+    return (cbc->pos_start[v + 1] - cbc->pos_start[v]) + (cbc->neg_start[v + 1] - cbc->neg_start[v]);
+}
+
+static uint32_t edge_target(const CompiledBC *cbc, uint32_t v, uint32_t e) {
+    uint32_t npos = cbc->pos_start[v + 1] - cbc->pos_start[v];
+    uint32_t r = e < npos ? cbc->pos_rules[cbc->pos_start[v] + e] : cbc->neg_rules[cbc->neg_start[v] + e - npos];
+    return cbc->conclusions[r] >> 1;
+}
+
+/*
+ * Iterative Tarjan over the symbol graph. Components are numbered in
+ * reverse topological order (a component is numbered before any component
+ * that has an edge into it).
+ */
+static uint32_t tarjan_scc(const CompiledBC *cbc, uint32_t *comp) {
+    uint32_t n = cbc->nsyms;
+    size_t sz = n ? n : 1;
+    uint32_t *index = (uint32_t*)malloc(sz * sizeof(uint32_t));
+    uint32_t *low = (uint32_t*)malloc(sz * sizeof(uint32_t));
+    unsigned char *on_stack = (unsigned char*)calloc(sz, 1);
+    uint32_t *stack = (uint32_t*)malloc(sz * sizeof(uint32_t));
+    TarjanFrame *calls = (TarjanFrame*)malloc(sz * sizeof(TarjanFrame));
+    const uint32_t UNVISITED = UINT32_MAX;
+    uint32_t sp = 0, ncomp = 0, counter = 0;
+    for (uint32_t v = 0; v < n; ++v) index[v] = UNVISITED;
+
+    for (uint32_t root = 0; root < n; ++root) {
+        if (index[root] != UNVISITED) continue;
+        long depth = 0;
+        calls[0].v = root; calls[0].edge = 0;
+        index[root] = low[root] = counter++;
+        stack[sp++] = root; on_stack[root] = 1;
+        while (depth >= 0) {
+            TarjanFrame *f = &calls[depth];
+            uint32_t v = f->v;
+            if (f->edge < out_degree(cbc, v)) {
+                uint32_t w = edge_target(cbc, v, f->edge++);
+                if (index[w] == UNVISITED) {
+                    index[w] = low[w] = counter++;
+                    stack[sp++] = w; on_stack[w] = 1;
+                    ++depth;
+                    calls[depth].v = w; calls[depth].edge = 0;
+                } else if (on_stack[w] && index[w] < low[v]) {
+                    low[v] = index[w];
+                }
+                continue;
+            }
+            if (low[v] == index[v]) {
+                uint32_t w;
+                do {
+                    w = stack[--sp];
+                    on_stack[w] = 0;
+                    comp[w] = ncomp;
+                } while (w != v);
+                ncomp++;
+            }
+            if (--depth >= 0) {
+                uint32_t parent = calls[depth].v;
+                if (low[v] < low[parent]) low[parent] = low[v];
+            }
+        }
+    }
+    free(calls);
+    free(stack);
+    free(on_stack);
+    free(low);
+    free(index);
+    return ncomp;
+}
+
+/**
+ * Calcule les strates d'une base compilée (algorithme de Tarjan).
+ * @param cbc Base compilée.
+ * @param out Sortie: strates (à libérer avec strata_free).
+ * @return 1 si la base est stratifiable, 0 sinon.
+ */
+int inference_stratify(const CompiledBC *cbc, Strata *out) {
+    if (!out) return 0;
+    out->count = 0; out->start = NULL; out->rules = NULL; out->cyclic = NULL;
+    out->stratified = 1; out->bad_symbol = SYMBOL_NONE;
+    if (!cbc) return 1;
+    uint32_t n = cbc->nsyms;
+    uint32_t *comp = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t ncomp = tarjan_scc(cbc, comp);
+
+    // A component is recursive if it has several symbols or a self-loop;
+    // a negated premise inside such a component cannot be stratified.
+    uint32_t *comp_size = (uint32_t*)calloc((size_t)ncomp + 1, sizeof(uint32_t));
+    unsigned char *comp_cyclic = (unsigned char*)calloc((size_t)ncomp + 1, 1);
+    for (uint32_t v = 0; v < n; ++v) comp_size[comp[v]]++;
+    for (uint32_t v = 0; v < n; ++v) {
+        if (comp_size[comp[v]] > 1) comp_cyclic[comp[v]] = 1;
+        for (uint32_t e = 0; e < out_degree(cbc, v); ++e) if (edge_target(cbc, v, e) == v) comp_cyclic[comp[v]] = 1;
+    }
+    for (uint32_t r = 0; r < cbc->nrules && out->stratified; ++r) {
+        const CompiledRule *h = &cbc->rules[r];
+        uint32_t c = cbc->conclusions[r] >> 1;
+        for (uint32_t k = h->npos; k < h->npos + h->nneg; ++k) {
+            if (comp[cbc->premises[h->start + k] >> 1] == comp[c]) {
+                out->stratified = 0;
+                out->bad_symbol = (int)c;
+                break;
+            }
+        }
+    }
+
+    // Number the components holding at least one rule in topological order
+    // (Tarjan numbers them in reverse), then bucket the rules stably.
+    long *stratum_of = (long*)malloc(((size_t)ncomp + 1) * sizeof(long));
+    for (uint32_t k = 0; k < ncomp; ++k) stratum_of[k] = -1;
+    for (uint32_t r = 0; r < cbc->nrules; ++r) stratum_of[comp[cbc->conclusions[r] >> 1]] = 0;
+    size_t count = 0;
+    for (uint32_t k = ncomp; k-- > 0;) if (stratum_of[k] == 0) stratum_of[k] = (long)count++;
+    out->count = count;
+    out->start = (size_t*)calloc(count + 1, sizeof(size_t));
+    out->cyclic = (unsigned char*)calloc(count ? count : 1, 1);
+    out->rules = (uint32_t*)malloc((cbc->nrules ? cbc->nrules : 1) * sizeof(uint32_t));
+    for (uint32_t k = 0; k < ncomp; ++k) if (stratum_of[k] >= 0) out->cyclic[stratum_of[k]] = comp_cyclic[k];
+    for (uint32_t r = 0; r < cbc->nrules; ++r) out->start[stratum_of[comp[cbc->conclusions[r] >> 1]] + 1]++;
+    for (size_t s = 0; s < count; ++s) out->start[s + 1] += out->start[s];
+    size_t *fill = (size_t*)malloc((count + 1) * sizeof(size_t));
+    memcpy(fill, out->start, (count + 1) * sizeof(size_t));
+    for (uint32_t r = 0; r < cbc->nrules; ++r) out->rules[fill[stratum_of[comp[cbc->conclusions[r] >> 1]]]++] = r;
+
+    free(fill);
+    free(stratum_of);
+    free(comp_cyclic);
+    free(comp_size);
+    free(comp);
+    return out->stratified;
+}
+
+/**
+ * Libère des strates.
+ * @param st Strates à libérer.
+ * @return Aucun.
+ */
+void strata_free(Strata *st) {
+    if (!st) return;
+    free(st->start);
+    free(st->rules);
+    free(st->cyclic);
+    st->start = NULL; st->rules = NULL; st->cyclic = NULL;
+    st->count = 0;
+}
+
+/**
+ * Chaînage avant stratifié à partir de strates précalculées, avec statistiques et justifications.
+ * @param cbc Base compilée.
+ * @param st Strates calculées par inference_stratify.
+ * @param bf Base de faits (modifiée en place).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications des faits déduits (NULL: aucune).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable.
+ */
+int strata_forward_chain_stats(const CompiledBC *cbc, const Strata *st, BaseFaits *bf, InferenceStats *stats, Justification *just) {
+    if (!cbc || !st || !bf || !st->stratified) return 0;
+    facts_reserve(bf, cbc->nsyms);
+    (void)stats; // unread when SYS_EXPERT_STATS is 0
+    STATS_ONLY(InferenceStats n; memset(&n, 0, sizeof(n)); double t0 = stats ? stats_now() : 0;)
+    uint32_t pass = 0;
+    for (size_t s = 0; s < st->count; ++s) {
+        int changed;
+        do {
+            changed = 0;
+            pass++;
+            STATS_ONLY(n.passes++;)
+            for (size_t k = st->start[s]; k < st->start[s + 1]; ++k) {
+                uint32_t r = st->rules[k];
+                uint32_t c = cbc->conclusions[r];
+                STATS_ONLY(n.rule_evaluations++;)
+                if (facts_has(bf, LIT_ID(c), LIT_NEG(c))) continue;
+                if (COMPILED_RULE_HOLDS(cbc, r, bf->pos, n.premise_checks)) {
+                    facts_add(bf, proposition_from_id(LIT_ID(c), LIT_NEG(c)));
+                    if (just) justification_record(just, c, r, pass);
+                    STATS_ONLY(n.rules_fired++; n.facts_derived++;)
+                    changed = 1;
+                }
+            }
+            // Premises of an acyclic stratum all live in earlier strata:
+            // a single pass reaches its fixpoint.
+        } while (changed && st->cyclic[s]);
+    }
+    STATS_ONLY(stats_merge(stats, &n); stats_add_time(stats, STATS_PHASE_INFER, t0);)
+    return 1;
+}
+
+/**
+ * Chaînage avant stratifié à partir de strates précalculées.
+ * @param cbc Base compilée.
+ * @param st Strates calculées par inference_stratify.
+ * @param bf Base de faits (modifiée en place).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable.
+ */
+int strata_forward_chain(const CompiledBC *cbc, const Strata *st, BaseFaits *bf) {
+    return strata_forward_chain_stats(cbc, st, bf, NULL, NULL);
+}
+
+/**
+ * Chaînage avant stratifié sur une base compilée.
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable.
+ */
+int inference_forward_chain_stratified_compiled(const CompiledBC *cbc, BaseFaits *bf) {
+    if (!cbc || !bf) return 0;
+    Strata st;
+    int ok = inference_stratify(cbc, &st) && strata_forward_chain(cbc, &st, bf);
+    strata_free(&st);
+    return ok;
+}
+
+/**
+ * Chaînage avant stratifié (compile la base, calcule les strates puis les évalue).
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable.
+ */
+int inference_forward_chain_stratified(const BC *bc, BaseFaits *bf) {
+    if (!bc || !bf) return 0;
+    CompiledBC cbc = bc_compile(bc);
+    int ok = inference_forward_chain_stratified_compiled(&cbc, bf);
+    compiled_free(&cbc);
+    return ok;
+}
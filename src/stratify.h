@@ -0,0 +1,73 @@
+#pragma once
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+
+// Découpage de la base en strates: composantes fortement connexes du graphe
+// de dépendance (prémisse -> conclusion), en ordre topologique.
+typedef struct Strata {
+    size_t count;           // nombre de strates
+    size_t *start;          // start[s]..start[s+1]: règles de la strate s
+    uint32_t *rules;        // indices de règles compilées, rangés par strate
+    unsigned char *cyclic;  // 1 si la strate contient une récursion positive
+    int stratified;         // 0 si une négation apparaît dans un cycle
+    int bad_symbol;         // conclusion d'une règle en cycle négatif (SYMBOL_NONE sinon)
+} Strata;
+
+/**
+ * Calcule les strates d'une base compilée (algorithme de Tarjan).
+ * Signale les bases non stratifiables (¬X dans un cycle passant par X).
+ * @param cbc Base compilée.
+ * @param out Sortie: strates (à libérer avec strata_free).
+ * @return 1 si la base est stratifiable, 0 sinon.
+ */
+int inference_stratify(const CompiledBC *cbc, Strata *out);
+
+/**
+ * Libère des strates.
+ * @param st Strates à libérer.
+ * @return Aucun.
+ */
+void strata_free(Strata *st);
+
+/**
+ * Chaînage avant stratifié à partir de strates précalculées.
+ * Chaque strate est évaluée une fois, dans l'ordre topologique: une prémisse
+ * ¬X est donc testée après que X a été entièrement déduit, ce qui rend le
+ * résultat indépendant de l'ordre des règles. Une strate acyclique demande
+ * une seule passe; une strate récursive est itérée jusqu'à stabilité locale.
+ * @param cbc Base compilée.
+ * @param st Strates calculées par inference_stratify.
+ * @param bf Base de faits (modifiée en place).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable (bf inchangée).
+ */
+int strata_forward_chain(const CompiledBC *cbc, const Strata *st, BaseFaits *bf);
+
+/**
+ * Comme strata_forward_chain, en cumulant les statistiques (une passe compte
+ * pour chaque tour sur une strate) et les justifications (passes numérotées
+ * de la première strate à la dernière).
+ * @param cbc Base compilée.
+ * @param st Strates calculées par inference_stratify.
+ * @param bf Base de faits (modifiée en place).
+ * @param stats Statistiques cumulées (NULL: aucune).
+ * @param just Justifications, créées pour cbc->nsyms symboles (NULL: aucune).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable (bf inchangée).
+ */
+int strata_forward_chain_stats(const CompiledBC *cbc, const Strata *st, BaseFaits *bf, InferenceStats *stats, Justification *just);
+
+/**
+ * Chaînage avant stratifié sur une base compilée (calcule les strates puis les évalue).
+ * @param cbc Base compilée.
+ * @param bf Base de faits (modifiée en place).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable (bf inchangée).
+ */
+int inference_forward_chain_stratified_compiled(const CompiledBC *cbc, BaseFaits *bf);
+
+/**
+ * Chaînage avant stratifié (compile la base, calcule les strates puis les évalue).
+ * @param bc Base de connaissances.
+ * @param bf Base de faits (modifiée en place).
+ * @return 1 si évaluée, 0 si la base n'est pas stratifiable (bf inchangée).
+ */
+int inference_forward_chain_stratified(const BC *bc, BaseFaits *bf);
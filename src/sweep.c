@@ -0,0 +1,232 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "batch.h"
+#include "compiled.h"
+#include "sweep.h"
+
+// Most rows per unit of work claimed by a thread (a multiple of BATCH_WIDTH).
+#define SWEEP_CHUNK_ROWS (16 * BATCH_WIDTH)
+// Bytes of formatted rows a thread buffers; chunks shrink to fit, down to one
+// block, and a block whose rows do not fit is written in slices.
+#define SWEEP_CHUNK_BYTES ((size_t)4 << 20)
+
+typedef struct SweepJob {
+    const CompiledBC *cbc;
+    const int *inputs;       // input symbols, column order
+    size_t ninputs;
+    const uint32_t *outputs; // conclusion literals, column order
+    size_t noutputs;
+    uint64_t total;          // 2^ninputs rows
+    uint64_t nchunks;
+    uint64_t chunk_rows;     // rows per chunk, a multiple of BATCH_WIDTH
+    size_t buf_rows;         // rows a thread's buffer holds (<= chunk_rows)
+    size_t row_len;          // bytes per row, '\n' included
+    uint64_t pattern[8][BATCH_WORDS]; // lanes of bit b of the row index within a block
+    uint64_t next_chunk;     // next chunk to claim (atomic)
+    // Ordered output: chunk c is written once chunks 0..c-1 are
+    pthread_mutex_t lock;
+    pthread_cond_t turn;
+    uint64_t next_write;
+    FILE *out;
+    int failed;
+} SweepJob;
+
+static int cmp_literal(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    int c = strcmp(symbol_name(LIT_ID(x)), symbol_name(LIT_ID(y)));
+    if (c) return c;
+    return (int)LIT_NEG(x) - (int)LIT_NEG(y);
+}
+
+// Distinct conclusion literals of the base, sorted by name
+static size_t collect_outputs(const CompiledBC *cbc, uint32_t **out) {
+    uint32_t *lits = (uint32_t*)malloc((cbc->nrules ? cbc->nrules : 1) * sizeof(uint32_t));
+    size_t n = 0;
+    for (uint32_t k = 0; k < 2 * cbc->nsyms; ++k) {
+        if (cbc->concl_start[k + 1] > cbc->concl_start[k]) lits[n++] = k;
+    }
+    if (n > 1) qsort(lits, n, sizeof(uint32_t), cmp_literal);
+    *out = lits;
+    return n;
+}
+
+// Evaluates the block of rows starting at 'base' (a multiple of BATCH_WIDTH)
+static void sweep_block(const SweepJob *job, BatchBlock *b, uint64_t base) {
+    size_t k = job->ninputs;
+    batch_block_clear(b);
+    // Column j holds bit (k-1-j) of the row index: the low 8 bits vary
+    // inside the block, the others are constant over it.
+    for (size_t j = 0; j < k; ++j) {
+        size_t bit = k - 1 - j;
+        uint64_t *lane = batch_lane(b, job->inputs[j], 0);
+        for (int w = 0; w < BATCH_WORDS; ++w) {
+            lane[w] = bit < 8 ? job->pattern[bit][w] : (((base >> bit) & 1) ? ~(uint64_t)0 : 0);
+        }
+    }
+    batch_block_run(b);
+}
+
+// Formats rows base+first .. base+first+count-1 of an evaluated block into buf
+static size_t sweep_rows(const SweepJob *job, const BatchBlock *b, uint64_t base, size_t first, size_t count,
+                         char *buf) {
+    size_t k = job->ninputs, len = 0;
+    for (size_t s = first; s < first + count; ++s) {
+        uint64_t row = base + s;
+        char *p = buf + len;
+        for (size_t j = 0; j < k; ++j) *p++ = (char)('0' + ((row >> (k - 1 - j)) & 1));
+        *p++ = ' ';
+        for (size_t o = 0; o < job->noutputs; ++o) {
+            const uint64_t *lane = b->lanes + (size_t)job->outputs[o] * BATCH_WORDS;
+            *p++ = (char)('0' + ((lane[s >> 6] >> (s & 63)) & 1));
+        }
+        *p = '\n';
+        len += job->row_len;
+    }
+    return len;
+}
+
+// Evaluates rows [first, last) of the table into buf, returns bytes written
+static size_t sweep_chunk(const SweepJob *job, BatchBlock *b, uint64_t first, uint64_t last, char *buf) {
+    size_t len = 0;
+    for (uint64_t base = first; base < last; base += BATCH_WIDTH) {
+        size_t count = (size_t)(last - base < BATCH_WIDTH ? last - base : BATCH_WIDTH);
+        sweep_block(job, b, base);
+        len += sweep_rows(job, b, base, 0, count, buf + len);
+    }
+    return len;
+}
+
+static void *sweep_worker(void *arg) {
+    SweepJob *job = (SweepJob*)arg;
+    BatchBlock b = batch_block_create(job->cbc, 0);
+    char *buf = (char*)malloc(job->buf_rows * job->row_len);
+    // Rows too wide for a whole block: the block is evaluated up front but
+    // formatted in slices once it is this thread's turn to write
+    int sliced = job->buf_rows < job->chunk_rows;
+    for (;;) {
+        // Idle threads take the next unclaimed chunk, so uneven chunks
+        // (deep vs shallow inference) balance themselves out.
+        uint64_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->nchunks) break;
+        uint64_t first = c * job->chunk_rows;
+        uint64_t last = first + job->chunk_rows < job->total ? first + job->chunk_rows : job->total;
+        size_t len = 0;
+        if (sliced) sweep_block(job, &b, first);
+        else len = sweep_chunk(job, &b, first, last, buf);
+
+        // Chunks are claimed in increasing order, so the one we wait for is
+        // already being computed: at most one buffered chunk per thread.
+        pthread_mutex_lock(&job->lock);
+        while (job->next_write != c) pthread_cond_wait(&job->turn, &job->lock);
+        if (sliced) {
+            for (size_t s = 0; s < last - first && !job->failed; s += job->buf_rows) {
+                size_t count = last - first - s < job->buf_rows ? (size_t)(last - first - s) : job->buf_rows;
+                len = sweep_rows(job, &b, first, s, count, buf);
+                if (fwrite(buf, 1, len, job->out) != len) job->failed = 1;
+            }
+        } else if (!job->failed && fwrite(buf, 1, len, job->out) != len) {
+            job->failed = 1;
+        }
+        job->next_write++;
+        pthread_cond_broadcast(&job->turn);
+        pthread_mutex_unlock(&job->lock);
+    }
+    free(buf);
+    batch_block_free(&b);
+    return NULL;
+}
+
+/**
+ * Balaye toutes les combinaisons des entrées d'une base compilée.
+ * @param cbc Base compilée.
+ * @param out Flux de sortie.
+ * @param threads Nombre de threads (<= 0: nombre de cœurs).
+ * @param rows Sortie optionnelle: nombre de lignes écrites.
+ * @return 1 si succès, 0 si trop d'entrées ou erreur d'écriture.
+ */
+int inference_sweep_compiled(const CompiledBC *cbc, FILE *out, int threads, uint64_t *rows) {
+    if (rows) *rows = 0;
+    if (!cbc || !out) return 0;
+    int *inputs = NULL;
+    size_t ninputs = compiled_input_symbols(cbc, &inputs);
+    if (ninputs > SWEEP_MAX_INPUTS) {
+        free(inputs);
+        return 0;
+    }
+
+    SweepJob job;
+    memset(&job, 0, sizeof(job));
+    job.cbc = cbc;
+    job.inputs = inputs;
+    job.ninputs = ninputs;
+    uint32_t *outputs = NULL;
+    job.noutputs = collect_outputs(cbc, &outputs);
+    job.outputs = outputs;
+    job.total = (uint64_t)1 << ninputs;
+    job.row_len = ninputs + 1 + job.noutputs + 1;
+    // Chunks from the byte budget: one byte per conclusion makes rows of a
+    // large base wide, and a fixed row count would buffer gigabytes per thread
+    size_t fit = SWEEP_CHUNK_BYTES / job.row_len;
+    if (fit == 0) fit = 1;
+    job.chunk_rows = fit / BATCH_WIDTH * BATCH_WIDTH;
+    if (job.chunk_rows < BATCH_WIDTH) job.chunk_rows = BATCH_WIDTH;
+    if (job.chunk_rows > SWEEP_CHUNK_ROWS) job.chunk_rows = SWEEP_CHUNK_ROWS;
+    job.buf_rows = fit < job.chunk_rows ? fit : (size_t)job.chunk_rows;
+    job.nchunks = (job.total + job.chunk_rows - 1) / job.chunk_rows;
+    for (int bit = 0; bit < 8; ++bit) {
+        for (int s = 0; s < BATCH_WIDTH; ++s) {
+            if ((s >> bit) & 1) job.pattern[bit][s >> 6] |= (uint64_t)1 << (s & 63);
+        }
+    }
+    job.out = out;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.turn, NULL);
+
+    for (size_t j = 0; j < ninputs; ++j) fprintf(out, "%s%s", j ? " " : "", symbol_name(inputs[j]));
+    fprintf(out, "%s|", ninputs ? " " : "");
+    for (size_t o = 0; o < job.noutputs; ++o) {
+        fprintf(out, " %s%s", LIT_NEG(outputs[o]) ? "¬" : "", symbol_name(LIT_ID(outputs[o])));
+    }
+    fputc('\n', out);
+
+    if (threads <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (int)n : 1;
+    }
+    if ((uint64_t)threads > job.nchunks) threads = (int)job.nchunks;
+    pthread_t *tids = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    int started = 0;
+    for (int t = 1; t < threads; ++t) {
+        if (pthread_create(&tids[started], NULL, sweep_worker, &job) == 0) started++;
+    }
+    sweep_worker(&job); // the calling thread works too
+    for (int t = 0; t < started; ++t) pthread_join(tids[t], NULL);
+    free(tids);
+
+    int ok = !job.failed && fflush(out) == 0;
+    if (ok && rows) *rows = job.total;
+    pthread_cond_destroy(&job.turn);
+    pthread_mutex_destroy(&job.lock);
+    free(outputs);
+    free(inputs);
+    return ok;
+}
+
+/**
+ * Balaye toutes les combinaisons des entrées et écrit la table de vérité.
+ * @param bc Base de connaissances.
+ * @param out Flux de sortie.
+ * @param threads Nombre de threads (<= 0: nombre de cœurs).
+ * @param rows Sortie optionnelle: nombre de lignes écrites.
+ * @return 1 si succès, 0 si trop d'entrées ou erreur d'écriture.
+ */
+int inference_sweep(const BC *bc, FILE *out, int threads, uint64_t *rows) {
+    if (rows) *rows = 0;
+    if (!bc || !out) return 0;
+    CompiledBC cbc = bc_compile(bc);
+    int ok = inference_sweep_compiled(&cbc, out, threads, rows);
+    compiled_free(&cbc);
+    return ok;
+}
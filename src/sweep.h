@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include "bc.h"
+#include "compiled.h"
+
+// Nombre maximal d'entrées balayées (2^SWEEP_MAX_INPUTS combinaisons).
+#define SWEEP_MAX_INPUTS 40
+
+/**
+ * Balaye toutes les combinaisons des entrées de la base (voir
+ * compiled_input_symbols) et écrit la table de vérité des conclusions.
+ * Format: une ligne d'en-tête "entrées | conclusions", puis une ligne par
+ * combinaison, dans l'ordre lexicographique (la première entrée varie le
+ * moins vite): les bits des entrées, un espace, les bits des conclusions.
+ * Le travail est réparti par tranches entre les threads; chaque tranche est
+ * écrite dès que les précédentes l'ont été, sans tout garder en mémoire.
+ * @param bc Base de connaissances.
+ * @param out Flux de sortie.
+ * @param threads Nombre de threads (<= 0: nombre de cœurs).
+ * @param rows Sortie optionnelle: nombre de lignes écrites.
+ * @return 1 si succès, 0 si trop d'entrées ou erreur d'écriture.
+ */
+int inference_sweep(const BC *bc, FILE *out, int threads, uint64_t *rows);
+
+/**
+ * Balaye toutes les combinaisons des entrées d'une base compilée
+ * (même format que inference_sweep).
+ * @param cbc Base compilée.
+ * @param out Flux de sortie.
+ * @param threads Nombre de threads (<= 0: nombre de cœurs).
+ * @param rows Sortie optionnelle: nombre de lignes écrites.
+ * @return 1 si succès, 0 si trop d'entrées ou erreur d'écriture.
+ */
+int inference_sweep_compiled(const CompiledBC *cbc, FILE *out, int threads, uint64_t *rows);
@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "symbol.h"
+
+// Symbols interned at run time. When an image is attached, local id i is
+// global id image.count + i.
+typedef struct SymbolTable {
+    const char **names;   // local id -> name
+    uint32_t *lens;       // local id -> name length
+    uint32_t *hashes;     // local id -> hash of name
+    int count;
+    int cap;
+    SymbolSlot *slots;    // open addressing over local ids
+    size_t slot_cap;      // power of two
+    Arena names_arena;    // names never move, so symbol_name() pointers stay valid
+    SymbolImage image;    // frozen first layer (count 0: none)
+} SymbolTable;
+
+static SymbolTable g_symbols = { NULL, NULL, NULL, 0, 0, NULL, 0, { NULL, 0, 0, 0 }, { 0, NULL, NULL, NULL, 0 } };
+
+/**
+ * Hache un nom (FNV-1a suivi d'un mélange final).
+ * @param name Début du nom.
+ * @param len Longueur du nom en octets.
+ * @return Valeur de hachage.
+ */
+uint32_t symbol_hash(const char *name, size_t len) {
+    uint32_t h = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    // Multiplication only carries upwards: mix the high bits back into the
+    // low ones used as the slot index.
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    return h;
+}
+
+static void rehash(size_t new_cap) {
+    SymbolSlot *slots = (SymbolSlot*)calloc(new_cap, sizeof(SymbolSlot));
+    size_t mask = new_cap - 1;
+    for (int id = 0; id < g_symbols.count; ++id) {
+        size_t i = g_symbols.hashes[id] & mask;
+        while (slots[i].id) i = (i + 1) & mask;
+        slots[i].hash = g_symbols.hashes[id];
+        slots[i].id = id + 1;
+    }
+    free(g_symbols.slots);
+    g_symbols.slots = slots;
+    g_symbols.slot_cap = new_cap;
+}
+
+// Returns the slot index holding 'name', or the empty slot where it belongs.
+static size_t find_slot(const char *name, size_t len, uint32_t h) {
+    size_t mask = g_symbols.slot_cap - 1;
+    size_t i = h & mask;
+    while (g_symbols.slots[i].id) {
+        int id = g_symbols.slots[i].id - 1;
+        if (g_symbols.slots[i].hash == h && g_symbols.lens[id] == len
+            && memcmp(g_symbols.names[id], name, len) == 0) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Looks 'name' up in the attached image; SYMBOL_NONE if absent.
+static int image_find(const char *name, size_t len, uint32_t h) {
+    const SymbolImage *img = &g_symbols.image;
+    if (img->count == 0) return SYMBOL_NONE;
+    size_t mask = img->slot_cap - 1;
+    size_t i = h & mask;
+    while (img->slots[i].id) {
+        int id = img->slots[i].id - 1;
+        if (img->slots[i].hash == h && img->offsets[id + 1] - img->offsets[id] - 1 == len
+            && memcmp(img->names + img->offsets[id], name, len) == 0) {
+            return id;
+        }
+        i = (i + 1) & mask;
+    }
+    return SYMBOL_NONE;
+}
+
+/**
+ * Interne un nom donné par un pointeur et une longueur (pas de '\0' requis).
+ * @param name Début du nom.
+ * @param len Longueur du nom en octets.
+ * @return Identifiant du symbole.
+ */
+int symbol_intern_n(const char *name, size_t len) {
+    if (!name) return SYMBOL_NONE;
+    uint32_t h = symbol_hash(name, len);
+    int found = image_find(name, len, h);
+    if (found != SYMBOL_NONE) return found;
+    if (!g_symbols.slots) rehash(64);
+    size_t slot = find_slot(name, len, h);
+    if (g_symbols.slots[slot].id) return g_symbols.image.count + g_symbols.slots[slot].id - 1;
+
+    if (g_symbols.count == g_symbols.cap) {
+        int cap = g_symbols.cap ? g_symbols.cap * 2 : 64;
+        g_symbols.names = (const char**)realloc((void*)g_symbols.names, sizeof(char*) * (size_t)cap);
+        g_symbols.lens = (uint32_t*)realloc(g_symbols.lens, sizeof(uint32_t) * (size_t)cap);
+        g_symbols.hashes = (uint32_t*)realloc(g_symbols.hashes, sizeof(uint32_t) * (size_t)cap);
+        g_symbols.cap = cap;
+    }
+    int id = g_symbols.count++;
+    g_symbols.names[id] = arena_strndup(&g_symbols.names_arena, name, len);
+    g_symbols.lens[id] = (uint32_t)len;
+    g_symbols.hashes[id] = h;
+    g_symbols.slots[slot].hash = h;
+    g_symbols.slots[slot].id = id + 1;
+    // Keep load factor under 1/2
+    if ((size_t)g_symbols.count * 2 > g_symbols.slot_cap) rehash(g_symbols.slot_cap * 2);
+    return g_symbols.image.count + id;
+}
+
+/**
+ * Interne un nom dans la table globale des symboles.
+ * @param name Nom à interner (chaîne terminée par '\0').
+ * @return Identifiant du symbole.
+ */
+int symbol_intern(const char *name) {
+    if (!name) return SYMBOL_NONE;
+    return symbol_intern_n(name, strlen(name));
+}
+
+/**
+ * Recherche un nom sans l'interner.
+ * @param name Nom recherché.
+ * @return Identifiant du symbole, ou SYMBOL_NONE s'il est inconnu.
+ */
+int symbol_lookup(const char *name) {
+    if (!name) return SYMBOL_NONE;
+    return symbol_lookup_n(name, strlen(name));
+}
+
+/**
+ * Recherche un nom donné par un pointeur et une longueur, sans l'interner.
+ * @param name Début du nom.
+ * @param len Longueur du nom en octets.
+ * @return Identifiant du symbole, ou SYMBOL_NONE s'il est inconnu.
+ */
+int symbol_lookup_n(const char *name, size_t len) {
+    if (!name) return SYMBOL_NONE;
+    uint32_t h = symbol_hash(name, len);
+    int found = image_find(name, len, h);
+    if (found != SYMBOL_NONE || !g_symbols.slots) return found;
+    size_t slot = find_slot(name, len, h);
+    return g_symbols.slots[slot].id ? g_symbols.image.count + g_symbols.slots[slot].id - 1 : SYMBOL_NONE;
+}
+
+/**
+ * Accède au nom d'un symbole.
+ * @param id Identifiant du symbole.
+ * @return Nom du symbole, "" si l'identifiant est invalide.
+ */
+const char *symbol_name(int id) {
+    if (id < 0) return "";
+    if (id < g_symbols.image.count) return g_symbols.image.names + g_symbols.image.offsets[id];
+    id -= g_symbols.image.count;
+    if (id >= g_symbols.count) return "";
+    return g_symbols.names[id];
+}
+
+/**
+ * Nombre de symboles internés.
+ * @return Nombre de symboles.
+ */
+int symbol_count(void) {
+    return g_symbols.image.count + g_symbols.count;
+}
+
+/**
+ * Adopte une image figée comme premiers symboles (identifiants 0..count-1).
+ * @param img Image (ses tableaux doivent survivre jusqu'à symbols_reset).
+ * @return 1 si adoptée, 0 si la table n'est pas vide ou l'image invalide.
+ */
+int symbols_attach(const SymbolImage *img) {
+    if (!img || symbol_count() != 0 || img->count < 0) return 0;
+    if (img->count == 0) return 1;
+    if (!img->offsets || !img->names || !img->slots) return 0;
+    // Probing needs a power-of-two table with at least one empty slot
+    if (img->slot_cap == 0 || (img->slot_cap & (img->slot_cap - 1)) || (size_t)img->count >= img->slot_cap) return 0;
+    g_symbols.image = *img;
+    return 1;
+}
+
+/**
+ * Libère la table des symboles.
+ * @return Aucun.
+ */
+void symbols_reset(void) {
+    arena_free(&g_symbols.names_arena);
+    free((void*)g_symbols.names);
+    free(g_symbols.lens);
+    free(g_symbols.hashes);
+    free(g_symbols.slots);
+    memset(&g_symbols, 0, sizeof(g_symbols));
+}
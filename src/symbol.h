@@ -0,0 +1,94 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Identifiant réservé pour "aucun symbole" (ex: règle sans conclusion).
+#define SYMBOL_NONE (-1)
+
+// Case de la table de hachage des noms (adressage ouvert, sondage linéaire).
+typedef struct SymbolSlot {
+    uint32_t hash;
+    int id;               // identifiant + 1, 0 = case vide
+} SymbolSlot;
+
+// Table de symboles figée, non possédée (ex: projetée depuis un instantané).
+// Le nom i occupe names[offsets[i] .. offsets[i+1]-1), '\0' final compris.
+typedef struct SymbolImage {
+    int count;
+    const uint32_t *offsets;  // count + 1 entrées
+    const char *names;
+    const SymbolSlot *slots;  // slot_cap cases, indexées par hash & (slot_cap - 1)
+    size_t slot_cap;          // puissance de deux > count
+} SymbolImage;
+
+/**
+ * Interne un nom dans la table globale des symboles.
+ * Le nom est copié une seule fois; les appels suivants avec le même
+ * nom renvoient le même identifiant (entiers denses 0, 1, 2, ...).
+ * @param name Nom à interner (chaîne terminée par '\0').
+ * @return Identifiant du symbole.
+ */
+int symbol_intern(const char *name);
+
+/**
+ * Interne un nom donné par un pointeur et une longueur (pas de '\0' requis).
+ * @param name Début du nom.
+ * @param len Longueur du nom en octets.
+ * @return Identifiant du symbole.
+ */
+int symbol_intern_n(const char *name, size_t len);
+
+/**
+ * Recherche un nom sans l'interner.
+ * @param name Nom recherché.
+ * @return Identifiant du symbole, ou SYMBOL_NONE s'il est inconnu.
+ */
+int symbol_lookup(const char *name);
+
+/**
+ * Recherche un nom donné par un pointeur et une longueur (pas de '\0'
+ * requis), sans l'interner. Ne modifie pas la table: plusieurs threads
+ * peuvent chercher en même temps tant qu'aucun n'interne.
+ * @param name Début du nom.
+ * @param len Longueur du nom en octets.
+ * @return Identifiant du symbole, ou SYMBOL_NONE s'il est inconnu.
+ */
+int symbol_lookup_n(const char *name, size_t len);
+
+/**
+ * Accède au nom d'un symbole.
+ * Le pointeur reste valide jusqu'à symbols_reset().
+ * @param id Identifiant du symbole.
+ * @return Nom du symbole, "" si l'identifiant est invalide.
+ */
+const char *symbol_name(int id);
+
+/**
+ * Nombre de symboles internés.
+ * @return Nombre de symboles (les identifiants valides sont 0..n-1).
+ */
+int symbol_count(void);
+
+/**
+ * Hache un nom comme le fait la table (pour construire une SymbolImage).
+ * @param name Début du nom.
+ * @param len Longueur du nom en octets.
+ * @return Valeur de hachage.
+ */
+uint32_t symbol_hash(const char *name, size_t len);
+
+/**
+ * Adopte une image figée comme premiers symboles (identifiants
+ * 0..count-1), sans copie. Les symboles internés ensuite prennent les
+ * identifiants suivants.
+ * @param img Image (ses tableaux doivent rester valides jusqu'à symbols_reset).
+ * @return 1 si adoptée, 0 si la table n'est pas vide ou l'image invalide.
+ */
+int symbols_attach(const SymbolImage *img);
+
+/**
+ * Libère la table des symboles (et détache l'image adoptée). Tous les
+ * identifiants et noms précédemment obtenus deviennent invalides.
+ * @return Aucun.
+ */
+void symbols_reset(void);
@@ -4,6 +4,11 @@
 #include <string.h>
 #include "ui.h"
 #include "inference.h"
+#include "version.h"
+#include "worker.h"
+
+// Key wait while a closure is being computed, to pick it up when it lands
+#define UI_POLL_MS 30
 
 typedef struct StrNode { char *s; struct StrNode *next; } StrNode;
 
@@ -25,169 +30,227 @@ static int strlist_index_of(StrNode *h, const char *s){ int i=0; for(;h;h=h->nex
 static const char* strlist_name_at(StrNode *h, int index){ int i=0; for(;h;h=h->next,++i) if(i==index) return h->s; return NULL; }
 static void strlist_remove_at(StrNode **h, int index){ if(!h||!*h||index<0) return; StrNode *prev=NULL,*cur=*h; int i=0; while(cur && i<index){ prev=cur; cur=cur->next; ++i; } if(!cur) return; if(prev) prev->next=cur->next; else *h=cur->next; free(cur->s); free(cur);} 
 static void strlist_append_unique(StrNode **h, const char *s){ if(strlist_contains(*h,s)) return; StrNode *n=(StrNode*)malloc(sizeof(StrNode)); n->s=strdup(s); n->next=NULL; if(!*h){ *h=n; return;} StrNode *t=*h; while(t->next) t=t->next; t->next=n; }
+static StrNode *strlist_copy(StrNode *h){ StrNode *out=NULL, **tail=&out; for(;h;h=h->next){ StrNode *n=(StrNode*)malloc(sizeof(StrNode)); n->s=strdup(h->s); n->next=NULL; *tail=n; tail=&n->next; } return out; }
 
 // Build variables: all premise names not appearing as any conclusion name
 static void build_variables(const BC *bc, StrNode **vars_out) {
-    StrNode *concls = NULL;
-    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
-        if (regle_has_conclusion(&rn->value)) {
-            Proposition c = regle_get_conclusion(&rn->value);
-            strlist_add_sorted_unique(&concls, c.name);
-        }
-    }
-    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
-        for (const ListPropositionNode *pn = rn->value.premises.head; pn; pn = pn->next) {
-            if (!strlist_contains(concls, pn->value.name)) {
-                strlist_add_sorted_unique(vars_out, pn->value.name);
-            }
-        }
-    }
-    strlist_free(concls);
+    int *ids = NULL;
+    size_t n = bc_input_symbols(bc, &ids);
+    for (size_t i = 0; i < n; ++i) strlist_add_sorted_unique(vars_out, symbol_name(ids[i]));
+    free(ids);
 }
 
 // Fallback: collect all premise names without filtering, for robustness
 static void build_premises_any(const BC *bc, StrNode **vars_out) {
     for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
         for (const ListPropositionNode *pn = rn->value.premises.head; pn; pn = pn->next) {
-            strlist_add_sorted_unique(vars_out, pn->value.name);
+            strlist_add_sorted_unique(vars_out, proposition_name(&pn->value));
         }
     }
 }
 
-// Rebuild derived facts from base toggles
-static void rebuild_facts(const BC *bc, StrNode *vars, int *base_states, BaseFaits *out) {
-    *out = facts_create();
+// Post the base toggles to the inference worker; bc is the edited base,
+// handed over as an O(1) version, or NULL when only toggles changed
+static void post_inputs(InferenceWorker *worker, const BC *bc, StrNode *vars, int *base_states) {
+    BaseFaits base = facts_create();
     int idx = 0;
     for (StrNode *v = vars; v; v = v->next, ++idx) {
-        if (base_states[idx]) facts_add(out, proposition_make(v->s, 0));
+        if (base_states[idx]) facts_add(&base, proposition_make(v->s, 0));
     }
-    inference_forward_chain(bc, out);
+    BCVersion snap;
+    if (bc) snap = bc_snapshot(bc);
+    inference_worker_post(worker, bc ? &snap : NULL, &base);
+    if (bc) version_release(&snap);
+    facts_free(&base);
 }
 
-// Check if a fact is true
-static int facts_has_name(const BaseFaits *bf, const char *name) {
-    Proposition p = proposition_make(name, 0);
-    int has = facts_contains(bf, &p);
-    proposition_free(&p);
-    return has;
+// One undo/redo step: a version of the base and the inputs shown with it
+typedef struct UiState { BCVersion version; StrNode *vars; int *states; int count; } UiState;
+typedef struct UiHistory { UiState *items; size_t len, cap; } UiHistory;
+
+static void history_push(UiHistory *h, const BC *bc, StrNode *vars, const int *states, int count) {
+    if (h->len == h->cap) { h->cap = h->cap ? 2*h->cap : 16; h->items = (UiState*)realloc(h->items, h->cap * sizeof(UiState)); }
+    UiState *st = &h->items[h->len++];
+    st->version = bc_snapshot(bc);
+    st->vars = strlist_copy(vars);
+    st->states = (int*)malloc(sizeof(int) * (size_t)(count > 0 ? count : 1));
+    if (count > 0) memcpy(st->states, states, sizeof(int) * (size_t)count);
+    st->count = count;
+}
+static void history_clear(UiHistory *h) {
+    for (size_t i = 0; i < h->len; ++i) { version_release(&h->items[i].version); strlist_free(h->items[i].vars); free(h->items[i].states); }
+    h->len = 0;
+}
+// Before an edit: the current state becomes undoable, redo is forgotten
+static void record_edit(UiHistory *undo, UiHistory *redo, const BC *bc, StrNode *vars, const int *states, int count) {
+    history_clear(redo);
+    history_push(undo, bc, vars, states, count);
 }
 
-// Simple name->line map for building rule layout
-typedef struct Map { const char *name; int line; struct Map *next;} Map;
-static void map_set_local(Map **pm, const char*name,int line){ Map *n=(Map*)malloc(sizeof(Map)); n->name=name; n->line=line; n->next=*pm; *pm=n; }
-static int map_get_local(Map *m,const char*name,int *line){ for(Map *x=m;x;x=x->next) if(strcmp(x->name,name)==0){*line=x->line; return 1;} return 0; }
+// One premise connector of a rule column
+typedef struct UiPrem { int line; int neg; int seq; } UiPrem;
 
-// Draw ASCII similar to print.c but with highlighting for facts
-static void draw_ascii(const BC *bc, StrNode *vars, const BaseFaits *facts, int cursor_row, int y_offset) {
-    // Build name->line for variables (even lines)
-    int var_count = strlist_len(vars);
-    int total_lines = var_count ? (2*var_count - 1) : 0;
-    int left_name_w = strlist_maxlen(vars);
-    int col_names  = 2; // space after cursor '>'
-    int left_w = col_names + left_name_w; // total left space before connectors
+// One rule column of the cached layout; its premises are sorted by line
+typedef struct UiRule {
+    const char *label;
+    int label_id;            // symbol of the conclusion, -1 if none
+    int label_w;
+    int top, bottom, label_line;
+    size_t start, count;     // range in UiLayout.prems
+} UiRule;
 
-    // Map name->line arrays
-    // To simplify, copy to arrays for O(1) index mapping
-    char **var_names = (char**)malloc(sizeof(char*)*var_count);
-    int i=0; for (StrNode *v=vars; v; v=v->next) var_names[i++]=v->s;
+// Graph layout, computed once per change of the base or of the inputs and
+// drawn through a viewport on every frame
+typedef struct UiLayout {
+    int var_count;
+    const char **var_names;  // point into the inputs list
+    int *var_ids;
+    int left_name_w;
+    int total_lines;
+    size_t nrules;
+    UiRule *rules;
+    UiPrem *prems;
+} UiLayout;
 
-    // Precompute rules draw info (top,bottom,label line, premises lines)
-    typedef struct PremI { int line; int neg; struct PremI *next; } PremI;
-    typedef struct RuleI { const char *label; int top,bottom,label_line; PremI *p; struct RuleI *next; } RuleI;
-    RuleI *rules=NULL, *rtail=NULL;
+static int cmp_prem(const void *a, const void *b) {
+    const UiPrem *x = (const UiPrem*)a, *y = (const UiPrem*)b;
+    if (x->line != y->line) return x->line < y->line ? -1 : 1;
+    return x->seq < y->seq ? -1 : (x->seq > y->seq);
+}
 
-    // temp map for rule outputs to line (label lines), enable chaining
-    Map *m=NULL;
+static void layout_free(UiLayout *lay) {
+    free(lay->var_names);
+    free(lay->var_ids);
+    free(lay->rules);
+    free(lay->prems);
+    memset(lay, 0, sizeof(*lay));
+}
 
-    // Seed map with variables
-    for (int k=0;k<var_count;++k) map_set_local(&m, var_names[k], 2*k);
+// Same layout as print.c: inputs on even lines, each rule's label on an odd
+// line between its premises, chained through the conclusion's line.
+static void layout_build(UiLayout *lay, const BC *bc, StrNode *vars) {
+    layout_free(lay);
+    int var_count = strlist_len(vars);
+    lay->var_count = var_count;
+    lay->var_names = (const char**)malloc(sizeof(char*) * (size_t)(var_count > 0 ? var_count : 1));
+    lay->var_ids = (int*)malloc(sizeof(int) * (size_t)(var_count > 0 ? var_count : 1));
+    int k = 0;
+    for (StrNode *v = vars; v; v = v->next, ++k) {
+        lay->var_names[k] = v->s;
+        lay->var_ids[k] = symbol_intern_n(v->s, strlen(v->s));
+    }
+    lay->left_name_w = strlist_maxlen(vars);
+    int total_lines = var_count ? (2*var_count - 1) : 0;
 
-    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
-        const Regle *r = &rn->value; int top= 1e9, bottom= -1e9; PremI *p=NULL,*pt=NULL;
+    // Line of each symbol by id; the last rule concluding it wins
+    size_t nsyms = (size_t)symbol_count();
+    int *line_of = (int*)malloc(sizeof(int) * (nsyms ? nsyms : 1));
+    for (size_t i = 0; i < nsyms; ++i) line_of[i] = -1;
+    for (k = 0; k < var_count; ++k) line_of[lay->var_ids[k]] = 2*k;
+
+    size_t nprems = 0, cap = 16;
+    lay->rules = (UiRule*)malloc(sizeof(UiRule) * (bc->regles.size ? bc->regles.size : 1));
+    lay->prems = (UiPrem*)malloc(sizeof(UiPrem) * cap);
+    size_t nr = 0;
+    for (const ListRegleNode *rn = bc->regles.head; rn; rn = rn->next, ++nr) {
+        const Regle *r = &rn->value; int top = 1e9, bottom = -1e9, seq = 0;
+        UiRule *ri = &lay->rules[nr];
+        ri->start = nprems;
         for (const ListPropositionNode *pn = r->premises.head; pn; pn = pn->next) {
-            int line = -1;
-            if (!map_get_local(m, pn->value.name, &line)) continue; // unknown yet
-            PremI *pi=(PremI*)malloc(sizeof(PremI)); pi->line=line; pi->neg=pn->value.negated?1:0; pi->next=NULL; if(!p)p=pt=pi; else {pt->next=pi; pt=pi;}
-            if (line<top) top=line;
-            if (line>bottom) bottom=line;
+            int id = pn->value.id;
+            if (id < 0 || (size_t)id >= nsyms || line_of[id] < 0) continue; // unknown yet
+            if (nprems == cap) { cap *= 2; lay->prems = (UiPrem*)realloc(lay->prems, sizeof(UiPrem) * cap); }
+            UiPrem *pi = &lay->prems[nprems++];
+            pi->line = line_of[id]; pi->neg = pn->value.negated ? 1 : 0; pi->seq = seq++;
+            if (pi->line < top) top = pi->line;
+            if (pi->line > bottom) bottom = pi->line;
         }
+        ri->count = nprems - ri->start;
         int label_line;
-        if (!p) { label_line = total_lines; if (label_line>=total_lines) total_lines=label_line+1; }
-        else { label_line = (top+bottom)/2; if ((label_line%2)==0) label_line = (label_line+1<=bottom)?label_line+1:((top+1<=bottom)?top+1:top); if ((label_line%2)==0){ label_line=bottom+1; if(label_line>=total_lines) total_lines=label_line+1; } }
-        RuleI *ri=(RuleI*)malloc(sizeof(RuleI)); ri->label = regle_has_conclusion(r)? regle_get_conclusion(r).name : ""; ri->top=top; ri->bottom=bottom; ri->label_line=label_line; ri->p=p; ri->next=NULL; if(!rules) rules=rtail=ri; else {rtail->next=ri; rtail=ri;}
-        if (regle_has_conclusion(r)) map_set_local(&m, regle_get_conclusion(r).name, label_line);
+        if (!ri->count) { label_line = total_lines; total_lines = label_line+1; top = -1; bottom = -1; }
+        else {
+            label_line = (top+bottom)/2;
+            if ((label_line%2)==0) label_line = (label_line+1<=bottom)?label_line+1:((top+1<=bottom)?top+1:top);
+            if ((label_line%2)==0){ label_line=bottom+1; if(label_line>=total_lines) total_lines=label_line+1; }
+            if (ri->count > 1) qsort(lay->prems + ri->start, ri->count, sizeof(UiPrem), cmp_prem);
+        }
+        ri->top = top; ri->bottom = bottom; ri->label_line = label_line;
+        ri->label_id = regle_has_conclusion(r) ? regle_get_conclusion(r).id : -1;
+        ri->label = ri->label_id >= 0 ? symbol_name(ri->label_id) : "";
+        ri->label_w = (int)strlen(ri->label);
+        if (ri->label_id >= 0) line_of[ri->label_id] = label_line;
     }
+    lay->nrules = nr;
+    lay->total_lines = total_lines;
+    free(line_of);
+}
 
-    // Draw rows
-    for (int row=0; row<total_lines; ++row) {
-        move(y_offset + row, 0);
-        clrtoeol();
-        // Cursor + variable names on even lines; guard for no variables
-        if (row % 2 == 0) {
-            int vindex = row/2;
-            if (vindex < var_count) {
-                // Cursor
-                if (vindex == cursor_row) addch('>'); else addch(' ');
-                addch(' ');
-                // Name with highlight if fact true (use same highlighting as rules: reverse)
-                const char *nm = var_names[vindex];
-                int is_true = facts_has_name(facts, nm);
-                if (is_true) attron(A_REVERSE);
-                addnstr(nm, left_name_w);
-                if ((int)strlen(nm) < left_name_w) for (int s=(int)strlen(nm); s<left_name_w; ++s) addch(' ');
-                if (is_true) attroff(A_REVERSE);
-            } else {
-                // No variable for this even row; pad the left area
-                for (int s=0; s<left_w; ++s) addch(' ');
-            }
-        } else {
-            // Non-variable separator line: just spaces up to left_w
-            for (int s=0; s<left_w; ++s) addch(' ');
-        }
+// Premise of a rule on a given line (first one listed wins), by bisection
+static const UiPrem *layout_prem_at(const UiLayout *lay, const UiRule *ri, int line) {
+    size_t lo = ri->start, hi = ri->start + ri->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (lay->prems[mid].line < line) lo = mid + 1; else hi = mid;
+    }
+    return lo < ri->start + ri->count && lay->prems[lo].line == line ? &lay->prems[lo] : NULL;
+}
 
-        // For each rule column, draw connectors and labels
-        int use_utf8 = (MB_CUR_MAX > 1);
-        const char *ch_vert = use_utf8 ? "│" : "|";
-        const char *ch_tee  = use_utf8 ? "┤" : "+";
-        const char *ch_top  = use_utf8 ? "┐" : "+";
-        const char *ch_bot  = use_utf8 ? "┘" : "+";
+// Draws the visible part of the cached layout: rows [top_row, top_row+height)
+// and the rule columns from first_col that fit in the screen width. The
+// input names stay in place when scrolling sideways. Returns the number of
+// rule columns drawn.
+static size_t draw_layout(const UiLayout *lay, const BaseFaits *facts, int cursor_row,
+                        int y_offset, int height, int top_row, size_t first_col) {
+    int left_name_w = lay->left_name_w;
+    int left_w = 2 + left_name_w; // cursor, space, names
+    int use_utf8 = (MB_CUR_MAX > 1);
+    const char *ch_vert = use_utf8 ? "│" : "|";
+    const char *ch_tee  = use_utf8 ? "┤" : "+";
+    const char *ch_top  = use_utf8 ? "┐" : "+";
+    const char *ch_bot  = use_utf8 ? "┘" : "+";
 
-        for (RuleI *ri=rules; ri; ri=ri->next) {
-            addch(' '); // spacer before connectors
-            // connector cell: two chars width like print.c (leading space or '!') + glyph
-            int is_segment = (ri->top>=0 && row>=ri->top && row<=ri->bottom);
-            int is_prem = 0, neg = 0;
-            if (is_segment) {
-                for (PremI *pi=ri->p; pi; pi=pi->next) if (pi->line==row){ is_prem=1; neg=pi->neg; break; }
-                addch(is_prem && neg ? '!' : ' ');
+    size_t shown = 0;
+    for (int x = left_w; first_col + shown < lay->nrules; ++shown) {
+        x += 4 + lay->rules[first_col + shown].label_w;
+        if (x > COLS) break;
+    }
+    int last_row = top_row + height < lay->total_lines ? top_row + height : lay->total_lines;
+    for (int row = top_row; row < last_row; ++row) {
+        move(y_offset + row - top_row, 0);
+        if (row % 2 == 0 && row/2 < lay->var_count) {
+            int vindex = row/2;
+            addch(vindex == cursor_row ? '>' : ' ');
+            addch(' ');
+            const char *nm = lay->var_names[vindex];
+            int is_true = facts_has(facts, lay->var_ids[vindex], 0);
+            if (is_true) attron(A_REVERSE);
+            addnstr(nm, left_name_w);
+            if (is_true) attroff(A_REVERSE);
+        }
+        // Rule columns that fit entirely on screen
+        int x = left_w;
+        for (size_t k = first_col; k < first_col + shown; ++k) {
+            const UiRule *ri = &lay->rules[k];
+            if (ri->top >= 0 && row >= ri->top && row <= ri->bottom) {
+                const UiPrem *pi = layout_prem_at(lay, ri, row);
                 const char *glyph = ch_vert;
                 if (ri->top == ri->bottom) glyph = ch_tee;
                 else if (row == ri->top) glyph = ch_top;
                 else if (row == ri->bottom) glyph = ch_bot;
-                else if (is_prem) glyph = ch_tee;
-                addstr(glyph);
-            } else {
-                addstr("  ");
+                else if (pi) glyph = ch_tee;
+                if (pi && pi->neg) mvaddch(y_offset + row - top_row, x + 1, '!');
+                mvaddstr(y_offset + row - top_row, x + 2, glyph);
             }
-            addch(' '); // space between connector and label
-            // Label column
-            int labw = (int)strlen(ri->label);
-            if (row == ri->label_line && labw > 0) {
-                int true_label = facts_has_name(facts, ri->label);
+            if (row == ri->label_line && ri->label_w > 0) {
+                int true_label = facts_has(facts, ri->label_id, 0);
                 if (true_label) attron(A_REVERSE);
-                addstr(ri->label);
+                mvaddstr(y_offset + row - top_row, x + 4, ri->label);
                 if (true_label) attroff(A_REVERSE);
-            } else {
-                for (int s=0; s<labw; ++s) addch(' ');
             }
+            x += 4 + ri->label_w;
         }
     }
-
-    free(var_names);
-    // free RuleI structures
-    for (RuleI *ri=rules; ri;) { RuleI *nx=ri->next; PremI *p=ri->p; while(p){PremI *pn=p->next; free(p); p=pn;} free(ri); ri=nx; }
-    // free map
-    for (Map *x=m; x;) { Map *nx=x->next; free(x); x=nx; }
+    return shown;
 }
 
 // Simple start menu, returns 0: Base exemple, 1: Base personnalisée, 2: Quiter
@@ -228,10 +291,10 @@ void run_ui(const BC *bc) {
         int choice = show_start_menu();
         if (choice == 2) { endwin(); return; }
 
-        // Prepare working knowledge base: example uses provided rules; personalized starts empty
-        BC local_bc; int use_local = (choice != 0);
-        if (use_local) { local_bc = bc_create(); }
-        const BC *kb = use_local ? (const BC*)&local_bc : bc;
+        // Prepare working knowledge base: example edits a private copy of the provided rules;
+        // personalized starts empty
+        BC local_bc = choice == 0 ? bc_copy(bc) : bc_create();
+        BC *kb = &local_bc;
 
         // Build initial variables based on menu
         StrNode *vars = NULL;
@@ -249,30 +312,90 @@ void run_ui(const BC *bc) {
             vars = NULL; var_count = 0; base_states = NULL;
         }
 
-        // Initial derived facts
-        BaseFaits facts = facts_create();
-        rebuild_facts(kb, vars, base_states, &facts);
+        // Closures are computed by a worker thread: keys never wait on
+        // inference, and the graph shows the latest finished closure
+        // Edits keep a persistent version of the base: each undo step holds
+        // one in O(1), sharing every rule it has in common with the others
+        bc_enable_versions(kb);
+        UiHistory undo = {0}, redo = {0};
+        InferenceWorker *worker = inference_worker_create();
+        BaseFaits shown = facts_create();
+        post_inputs(worker, kb, vars, base_states);
+
+        // Layout of the graph, rebuilt only when the base or the inputs change
+        UiLayout lay; memset(&lay, 0, sizeof(lay));
+        int layout_dirty = 1;
+        int top_row = 0; size_t first_col = 0; // viewport origin
 
         int selected = 0; int ch;
+        int redraw = 1, was_busy = 0;
         while (1) {
-            erase();
-            // Help header
-            attron(A_BOLD);
-            mvprintw(0, 0, "↑/↓ move  •  SPACE toggle  •  i add input  •  d del input  •  a add rule  •  r del rule  •  q menu");
-            attroff(A_BOLD);
-            // Draw graph starting one line below header
-            draw_ascii(kb, vars, &facts, selected, 1);
-            refresh();
+            // Busy first: a closure finished after this check is caught by
+            // the poll, so an idle wait never hides a result
+            int busy = inference_worker_busy(worker);
+            if (inference_worker_poll(worker, &shown)) redraw = 1;
+            if (busy != was_busy) { redraw = 1; was_busy = busy; }
+            if (layout_dirty) {
+                layout_build(&lay, kb, vars);
+                if (first_col >= lay.nrules) first_col = lay.nrules ? lay.nrules - 1 : 0;
+                layout_dirty = 0;
+            }
+            // Graph between the header and the status line; keep the
+            // selected input in view
+            int view_h = LINES - 2 > 1 ? LINES - 2 : 1;
+            if (2*selected < top_row) top_row = 2*selected;
+            else if (2*selected >= top_row + view_h) top_row = 2*selected - view_h + 1;
+            if (top_row > lay.total_lines - view_h) top_row = lay.total_lines - view_h;
+            if (top_row < 0) top_row = 0;
+
+            if (redraw) {
+                erase();
+                // Help header
+                attron(A_BOLD);
+                mvprintw(0, 0, "↑/↓ move  •  ←/→ scroll  •  SPACE toggle  •  i add input  •  d del input  •  a add rule  •  r del rule  •  u/U undo/redo  •  q menu");
+                attroff(A_BOLD);
+                if (busy) { attron(A_REVERSE); mvprintw(0, COLS > 12 ? COLS - 12 : 0, " computing… "); attroff(A_REVERSE); }
+                size_t ncols = draw_layout(&lay, &shown, selected, 1, view_h, top_row, first_col);
+                if (lay.total_lines > view_h || ncols < lay.nrules) {
+                    mvprintw(LINES-1, 0, "lines %d-%d/%d  rules %zu-%zu/%zu",
+                             lay.total_lines ? top_row + 1 : 0,
+                             top_row + view_h < lay.total_lines ? top_row + view_h : lay.total_lines,
+                             lay.total_lines, ncols ? first_col + 1 : 0, first_col + ncols, lay.nrules);
+                }
+                refresh();
+                redraw = 0;
+            }
+            timeout(busy ? UI_POLL_MS : -1);
             ch = getch();
+            timeout(-1);
+            if (ch == ERR) continue;
+            redraw = 1;
             if (ch == 'q' || ch == 'Q') break; // return to main menu
             else if (ch == KEY_UP) { if (selected>0) selected--; }
             else if (ch == KEY_DOWN) { if (selected < var_count-1) selected++; }
+            else if (ch == KEY_PPAGE) { selected -= view_h/2 > 0 ? view_h/2 : 1; if (selected < 0) selected = 0; }
+            else if (ch == KEY_NPAGE) { selected += view_h/2 > 0 ? view_h/2 : 1; if (selected > var_count-1) selected = var_count > 0 ? var_count-1 : 0; }
+            else if (ch == KEY_LEFT) { if (first_col > 0) first_col--; }
+            else if (ch == KEY_RIGHT) { if (first_col + 1 < lay.nrules) first_col++; }
             else if (ch == ' ') {
                 if (var_count>0) {
+                    // Supersedes a toggle still being computed
                     base_states[selected] = !base_states[selected];
-                    facts_free(&facts);
-                    rebuild_facts(kb, vars, base_states, &facts);
+                    post_inputs(worker, NULL, vars, base_states);
                 }
+            } else if ((ch == 'u' && undo.len > 0) || (ch == 'U' && redo.len > 0)) {
+                // Undo/redo: the other stack gets the current state, then
+                // the base is checked out from the popped version
+                UiHistory *from = ch == 'u' ? &undo : &redo, *to = ch == 'u' ? &redo : &undo;
+                history_push(to, kb, vars, base_states, var_count);
+                UiState st = from->items[--from->len];
+                bc_checkout(kb, &st.version);
+                version_release(&st.version);
+                strlist_free(vars); free(base_states);
+                vars = st.vars; base_states = st.states; var_count = st.count;
+                if (selected >= var_count) selected = var_count > 0 ? var_count-1 : 0;
+                layout_dirty = 1;
+                post_inputs(worker, kb, vars, base_states);
             } else if (ch == 'i' || ch == 'I') {
                 // Add input: prompt for name
                 echo(); curs_set(1);
@@ -282,13 +405,14 @@ void run_ui(const BC *bc) {
                 noecho(); curs_set(0);
                 if (buf[0]) {
                     if (!strlist_contains(vars, buf)) {
+                        record_edit(&undo, &redo, kb, vars, base_states, var_count);
                         strlist_append_unique(&vars, buf);
                         // grow base_states
                         base_states = (int*)realloc(base_states, sizeof(int)*(var_count+1));
                         base_states[var_count] = 0;
                         var_count++;
-                        facts_free(&facts);
-                        rebuild_facts(kb, vars, base_states, &facts);
+                        layout_dirty = 1;
+                        // New inputs start OFF: the closure is unchanged
                     }
                 }
             } else if (ch == 'd' || ch == 'D') {
@@ -296,102 +420,67 @@ void run_ui(const BC *bc) {
                 if (var_count>0) {
                     const char *name = strlist_name_at(vars, selected);
                     if (name) {
-                        // Remove this premise from all rules
-                        for (const ListRegleNode *rn = kb->regles.head; rn; rn = rn->next) {
-                            regle_remove_premises_by_name((Regle*)&rn->value, name);
-                        }
-                        // Cascade: remove any rules that have become empty, and
-                        // then remove references to those rules from other rules,
-                        // repeating until closure.
-                        StrNode *to_delete = NULL;   // queue of rule labels to delete
-                        StrNode *deleted = NULL;     // set of already deleted labels
-                        // seed with currently empty rules
-                        for (const ListRegleNode *rn = kb->regles.head; rn; rn = rn->next) {
-                            const Regle *r = &rn->value;
-                            if (regle_premise_is_empty(r) && regle_has_conclusion(r)) {
-                                strlist_append_unique(&to_delete, regle_get_conclusion(r).name);
-                            }
-                        }
-                        while (to_delete) {
-                            const char *labptr = strlist_name_at(to_delete, 0);
-                            char labbuf[256]; memset(labbuf,0,sizeof(labbuf));
-                            if (labptr) { strncpy(labbuf, labptr, sizeof(labbuf)-1); }
-                            // pop head
-                            strlist_remove_at(&to_delete, 0);
-                            // skip if already deleted
-                            if (strlist_contains(deleted, labbuf)) continue;
-                            // delete the rule itself
-                            bc_remove_rule_by_label((BC*)kb, labbuf);
-                            // remove its premise references from remaining rules
-                            for (const ListRegleNode *rn = kb->regles.head; rn; rn = rn->next) {
-                                regle_remove_premises_by_name((Regle*)&rn->value, labbuf);
-                            }
-                            // find newly empty rules to delete next
-                            for (const ListRegleNode *rn = kb->regles.head; rn; rn = rn->next) {
-                                const Regle *r = &rn->value;
-                                if (regle_premise_is_empty(r) && regle_has_conclusion(r)) {
-                                    const char *nm = regle_get_conclusion(r).name;
-                                    if (!strlist_contains(deleted, nm)) {
-                                        strlist_append_unique(&to_delete, nm);
-                                    }
-                                }
-                            }
-                            // mark as deleted
-                            strlist_append_unique(&deleted, labbuf);
-                        }
-                        strlist_free(to_delete);
-                        strlist_free(deleted);
+                        // Remove it from all rules, then every rule and
+                        // conclusion left without support, until closure
+                        record_edit(&undo, &redo, kb, vars, base_states, var_count);
+                        bc_remove_symbol_cascade(kb, symbol_lookup(name), NULL);
+                        layout_dirty = 1;
 
                         // Remove from vars and states
                         strlist_remove_at(&vars, selected);
                         for (int k=selected; k<var_count-1; ++k) base_states[k] = base_states[k+1];
                         var_count--; if (var_count==0) selected = 0; else if (selected>=var_count) selected = var_count-1;
                         base_states = (int*)realloc(base_states, sizeof(int)* (var_count>0?var_count:1));
-                        facts_free(&facts);
-                        rebuild_facts(kb, vars, base_states, &facts);
+                        post_inputs(worker, kb, vars, base_states);
                     }
                 }
             } else if (ch == 'a' || ch == 'A') {
                 // Add rule: choose premises (vars + existing rules) with polarity, then label
                 // Gather rule labels from current KB
-                StrNode *rule_labels = NULL;
+                StrNode *rule_labels = NULL, **labels_tail = &rule_labels;
                 for (const ListRegleNode *rn=kb->regles.head; rn; rn=rn->next) {
-                    if (regle_has_conclusion(&rn->value)) {
-                        const char *nm = regle_get_conclusion(&rn->value).name;
+                    // One entry per conclusion: its first rule in the index
+                    if (regle_has_conclusion(&rn->value)
+                        && bc_rules_concluding(kb, regle_get_conclusion(&rn->value).id) == rn) {
+                        const char *nm = symbol_name(regle_get_conclusion(&rn->value).id);
                         // avoid duplicate if same as a variable name
-                        if (!strlist_contains(vars, nm)) strlist_append_unique(&rule_labels, nm);
+                        if (!strlist_contains(vars, nm)) {
+                            StrNode *n=(StrNode*)malloc(sizeof(StrNode)); n->s=strdup(nm); n->next=NULL;
+                            *labels_tail = n; labels_tail = &n->next;
+                        }
                     }
                 }
                 int rule_count = strlist_len(rule_labels);
                 int total_items = var_count + rule_count;
+                // Inputs then rule labels, indexed once for the whole menu
+                const char **items = (const char**)malloc(sizeof(char*) * (size_t)(total_items>0?total_items:1));
+                for (int r=0; r<var_count; ++r) items[r] = lay.var_names[r];
+                { int r = var_count; for (StrNode *l=rule_labels; l; l=l->next) items[r++] = l->s; }
                 int *sel_state = (int*)calloc((size_t)(total_items>0?total_items:1), sizeof(int)); // 0 none, 1 pos, 2 neg
-                int rr = 0; int add_ch;
+                int rr = 0; int add_ch; int menu_top = 0;
                 while (1) {
                     erase();
                     attron(A_BOLD); mvprintw(0,0, "Add rule: ↑/↓ move  •  space select +  •  ! toggle +/-  •  ENTER confirm  •  q cancel"); attroff(A_BOLD);
-                    // Render variables first
-                    int liney = 2;
-                    for (int r=0; r<var_count; ++r, ++liney) {
-                        move(liney,0); clrtoeol(); addch((r==rr)?'>':' '); addch(' ');
-                        int st = sel_state[r];
-                        addstr(st==2 ? "!" : " ");
-                        addstr(strlist_name_at(vars, r));
-                        addstr((st==1||st==2)?"  [x]":"  [ ]");
-                    }
-                    // Separator if there are rule labels
-                    if (rule_count>0) { move(liney,0); clrtoeol(); addstr("-- rules --"); ++liney; }
-                    // Render rule labels
-                    for (int r=0; r<rule_count; ++r, ++liney) {
-                        int idx = var_count + r;
-                        move(liney,0); clrtoeol(); addch((idx==rr)?'>':' '); addch(' ');
+                    // Menu rows: inputs, a separator before the rule labels,
+                    // then the labels; only the rows on screen are drawn
+                    int menu_h = LINES - 3 > 1 ? LINES - 3 : 1;
+                    int menu_rows = total_items + (rule_count > 0);
+                    int cur_row = rr < var_count ? rr : rr + 1;
+                    if (cur_row < menu_top) menu_top = cur_row;
+                    else if (cur_row >= menu_top + menu_h) menu_top = cur_row - menu_h + 1;
+                    for (int row=menu_top; row<menu_rows && row<menu_top+menu_h; ++row) {
+                        move(2 + row - menu_top, 0);
+                        if (row == var_count && rule_count > 0) { addstr("-- rules --"); continue; }
+                        int idx = row < var_count ? row : row - 1;
+                        addch((idx==rr)?'>':' '); addch(' ');
                         int st = sel_state[idx];
                         addstr(st==2 ? "!" : " ");
-                        addstr(strlist_name_at(rule_labels, r));
+                        addstr(items[idx]);
                         addstr((st==1||st==2)?"  [x]":"  [ ]");
                     }
                     refresh();
                     add_ch = getch();
-                    if (add_ch=='q' || add_ch=='Q') { free(sel_state); sel_state=NULL; strlist_free(rule_labels); rule_labels=NULL; break; }
+                    if (add_ch=='q' || add_ch=='Q') { free(items); free(sel_state); sel_state=NULL; strlist_free(rule_labels); rule_labels=NULL; break; }
                     else if (add_ch==KEY_UP) { if (rr>0) rr--; }
                     else if (add_ch==KEY_DOWN) { if (rr<total_items-1) rr++; }
                     else if (add_ch==' ') { if (total_items>0) sel_state[rr] = (sel_state[rr]==0)?1:0; }
@@ -404,54 +493,60 @@ void run_ui(const BC *bc) {
                         getnstr(lab, 127);
                         noecho(); curs_set(0);
                         if (lab[0]) {
-                            Regle nr = regle_create();
-                            // Add selected variable premises
-                            for (int r=0; r<var_count; ++r) {
-                                if (sel_state[r]==1) regle_add_premise(&nr, proposition_make(strlist_name_at(vars,r), 0));
-                                else if (sel_state[r]==2) regle_add_premise(&nr, proposition_make(strlist_name_at(vars,r), 1));
-                            }
-                            // Add selected rule-label premises
-                            for (int r=0; r<rule_count; ++r) {
-                                int idx = var_count + r;
-                                const char *nm = strlist_name_at(rule_labels, r);
-                                if (sel_state[idx]==1) regle_add_premise(&nr, proposition_make(nm, 0));
-                                else if (sel_state[idx]==2) regle_add_premise(&nr, proposition_make(nm, 1));
+                            Regle nr = regle_create_in(kb->arena);
+                            // Add selected premises: inputs, then rule labels
+                            for (int idx=0; idx<total_items; ++idx) {
+                                if (sel_state[idx]==1) regle_add_premise(&nr, proposition_make(items[idx], 0));
+                                else if (sel_state[idx]==2) regle_add_premise(&nr, proposition_make(items[idx], 1));
                             }
                             regle_set_conclusion(&nr, proposition_make(lab, 0));
-                            bc_add_regle((BC*)kb, nr);
-                            facts_free(&facts);
-                            rebuild_facts(kb, vars, base_states, &facts);
+                            record_edit(&undo, &redo, kb, vars, base_states, var_count);
+                            bc_add_regle(kb, nr);
+                            layout_dirty = 1;
+                            post_inputs(worker, kb, vars, base_states);
                         }
-                        free(sel_state); sel_state=NULL; strlist_free(rule_labels); rule_labels=NULL; break;
+                        free(items); free(sel_state); sel_state=NULL; strlist_free(rule_labels); rule_labels=NULL; break;
                     }
                 }
             } else if (ch == 'r' || ch == 'R') {
-                // Remove rule by selecting from list of rule labels
-                // Build list of labels
-                int rc = 0; for (const ListRegleNode *rn=kb->regles.head; rn; rn=rn->next) if (regle_has_conclusion(&rn->value)) rc++;
+                // Remove rule by selecting from the list of rules; each entry keeps its node so
+                // rules sharing a conclusion are told apart
+                ListRegleNode **nodes = (ListRegleNode**)malloc(sizeof(ListRegleNode*)*(kb->regles.size ? kb->regles.size : 1));
+                int rc = 0; for (ListRegleNode *rn=kb->regles.head; rn; rn=rn->next) if (regle_has_conclusion(&rn->value)) nodes[rc++] = rn;
                 if (rc>0) {
-                    const char **labels = (const char**)malloc(sizeof(char*)*rc);
-                    int idx=0; for (const ListRegleNode *rn=kb->regles.head; rn; rn=rn->next) if (regle_has_conclusion(&rn->value)) { labels[idx++] = regle_get_conclusion(&rn->value).name; }
-                    int rrsel = 0; int rch;
+                    int rrsel = 0; int rch; int menu_top = 0;
                     while (1) {
                         erase(); attron(A_BOLD); mvprintw(0,0, "Remove rule: ↑/↓ move  •  ENTER delete  •  q cancel"); attroff(A_BOLD);
-                        for (int i=0;i<rc;++i){ move(2+i,0); clrtoeol(); addch((i==rrsel)?'>':' '); addch(' '); addstr(labels[i]); }
+                        // Only the labels on screen are drawn
+                        int menu_h = LINES - 3 > 1 ? LINES - 3 : 1;
+                        if (rrsel < menu_top) menu_top = rrsel;
+                        else if (rrsel >= menu_top + menu_h) menu_top = rrsel - menu_h + 1;
+                        for (int i=menu_top;i<rc && i<menu_top+menu_h;++i){
+                            const Regle *rr = &nodes[i]->value;
+                            move(2+i-menu_top,0); addch((i==rrsel)?'>':' '); addch(' '); addstr(symbol_name(regle_get_conclusion(rr).id)); addstr(" <= ");
+                            int first = 1;
+                            for (const ListPropositionNode *pn=rr->premises.head; pn; pn=pn->next) { if (!first) addstr(" & "); if (pn->value.negated) addch('!'); addstr(symbol_name(pn->value.id)); first = 0; }
+                        }
                         refresh();
                         rch=getch();
                         if (rch=='q'||rch=='Q') break;
                         else if (rch==KEY_UP){ if (rrsel>0) rrsel--; }
                         else if (rch==KEY_DOWN){ if (rrsel<rc-1) rrsel++; }
-                        else if (rch=='\n'||rch=='\r'||rch==KEY_ENTER){ bc_remove_rule_by_label((BC*)kb, labels[rrsel]); facts_free(&facts); rebuild_facts(kb, vars, base_states, &facts); break; }
+                        else if (rch=='\n'||rch=='\r'||rch==KEY_ENTER){ record_edit(&undo, &redo, kb, vars, base_states, var_count); bc_remove_rule(kb, nodes[rrsel]); layout_dirty = 1; post_inputs(worker, kb, vars, base_states); break; }
                     }
-                    free(labels);
                 }
+                free(nodes);
             }
         }
 
         // Cleanup this session and return to menu
-        facts_free(&facts);
+        history_clear(&undo); free(undo.items);
+        history_clear(&redo); free(redo.items);
+        layout_free(&lay);
+        inference_worker_free(worker);
+        facts_free(&shown);
         strlist_free(vars);
         free(base_states);
-        if (use_local) bc_free(&local_bc);
+        bc_free(&local_bc);
     }
 }
@@ -4,7 +4,12 @@
 /**
  * Lance l'interface ncurses pour visualiser la base de connaissances,
  * mettre en évidence les faits vrais, et permettre de basculer les
- * faits de base avec les flèches et la touche 'x'. 'q' pour quitter.
+ * faits de base (flèches et espace). Le graphe défile dans la fenêtre
+ * (←/→ pour les colonnes de règles). L'inférence tourne sur un thread
+ * à part: l'affichage montre la dernière clôture terminée. Les
+ * modifications s'annulent ('u') et se rétablissent ('U'). 'q' pour quitter.
+ * La base exemple est une copie privée de 'bc' (bc_copy): les
+ * modifications d'une session n'y sont pas reportées.
  * @param bc Base de connaissances (non modifiée).
  * @return Aucun.
  */
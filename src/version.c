@@ -0,0 +1,340 @@
+#include <stdlib.h>
+#include <string.h>
+#include "version.h"
+
+// Immutable copy of one rule, shared by every version that holds it
+typedef struct VersionRule {
+    int refs;
+    int has_conclusion;
+    Proposition conclusion;
+    uint32_t npremises;
+    Proposition premises[];
+} VersionRule;
+
+// Treap node keyed by the rule's insertion order. Nodes are never changed
+// once built: an edit copies the path from the root and shares the rest.
+struct VersionNode {
+    int refs;
+    uint32_t prio;
+    uint64_t key;
+    VersionNode *left;
+    VersionNode *right;
+    VersionRule *rule;
+};
+
+// Keys are sequential: a hashed priority keeps the treap balanced
+static uint32_t key_prio(uint64_t key) {
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return (uint32_t)((key ^ (key >> 31)) >> 32);
+}
+
+static VersionRule *rule_from(const Regle *r) {
+    uint32_t n = (uint32_t)r->premises.size;
+    VersionRule *vr = (VersionRule*)malloc(sizeof(VersionRule) + n * sizeof(Proposition));
+    vr->refs = 1;
+    vr->has_conclusion = r->has_conclusion;
+    vr->conclusion = r->conclusion;
+    vr->npremises = 0;
+    for (const ListPropositionNode *p = r->premises.head; p && vr->npremises < n; p = p->next) {
+        vr->premises[vr->npremises++] = p->value;
+    }
+    return vr;
+}
+
+// Reference counts are atomic: versions are released from reader threads
+static VersionNode *node_retain(VersionNode *n) {
+    if (n) __atomic_add_fetch(&n->refs, 1, __ATOMIC_RELAXED);
+    return n;
+}
+
+static void rule_release(VersionRule *r) {
+    if (r && __atomic_sub_fetch(&r->refs, 1, __ATOMIC_ACQ_REL) == 0) free(r);
+}
+
+static void node_release(VersionNode *n) {
+    while (n && __atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        VersionNode *right = n->right;
+        node_release(n->left);
+        rule_release(n->rule);
+        free(n);
+        n = right;
+    }
+}
+
+// New node owning the given references
+static VersionNode *node_make(uint64_t key, uint32_t prio, VersionNode *left, VersionNode *right, VersionRule *rule) {
+    VersionNode *n = (VersionNode*)malloc(sizeof(VersionNode));
+    n->refs = 1;
+    n->prio = prio;
+    n->key = key;
+    n->left = left;
+    n->right = right;
+    n->rule = rule;
+    return n;
+}
+
+// Copy of 'n' with new children (owned references) and the same rule
+static VersionNode *node_copy(const VersionNode *n, VersionNode *left, VersionNode *right) {
+    __atomic_add_fetch(&n->rule->refs, 1, __ATOMIC_RELAXED);
+    return node_make(n->key, n->prio, left, right, n->rule);
+}
+
+// The functions below read 't' without consuming it and return a new tree
+// (an owned reference) sharing every untouched subtree with 't'.
+
+// Keys < key go left, the others right
+static void tree_split(const VersionNode *t, uint64_t key, VersionNode **l, VersionNode **r) {
+    if (!t) {
+        *l = *r = NULL;
+        return;
+    }
+    VersionNode *a, *b;
+    if (t->key < key) {
+        tree_split(t->right, key, &a, &b);
+        *l = node_copy(t, node_retain(t->left), a);
+        *r = b;
+    } else {
+        tree_split(t->left, key, &a, &b);
+        *l = a;
+        *r = node_copy(t, b, node_retain(t->right));
+    }
+}
+
+// Every key of 'a' is below every key of 'b'
+static VersionNode *tree_merge(VersionNode *a, VersionNode *b) {
+    if (!a) return node_retain(b);
+    if (!b) return node_retain(a);
+    if (a->prio > b->prio) return node_copy(a, node_retain(a->left), tree_merge(a->right, b));
+    return node_copy(b, tree_merge(a, b->left), node_retain(b->right));
+}
+
+static VersionNode *tree_insert(const VersionNode *t, uint64_t key, uint32_t prio, VersionRule *rule) {
+    if (!t || prio > t->prio) {
+        VersionNode *l, *r;
+        tree_split(t, key, &l, &r);
+        return node_make(key, prio, l, r, rule);
+    }
+    if (key < t->key) return node_copy(t, tree_insert(t->left, key, prio, rule), node_retain(t->right));
+    return node_copy(t, node_retain(t->left), tree_insert(t->right, key, prio, rule));
+}
+
+static VersionNode *tree_erase(const VersionNode *t, uint64_t key) {
+    if (!t) return NULL;
+    if (key == t->key) return tree_merge(t->left, t->right);
+    if (key < t->key) return node_copy(t, tree_erase(t->left, key), node_retain(t->right));
+    return node_copy(t, node_retain(t->left), tree_erase(t->right, key));
+}
+
+// Swaps the rule of 'key' (rule is an owned reference)
+static VersionNode *tree_replace(const VersionNode *t, uint64_t key, VersionRule *rule) {
+    if (!t) {
+        rule_release(rule);
+        return NULL;
+    }
+    if (key == t->key) return node_make(t->key, t->prio, node_retain(t->left), node_retain(t->right), rule);
+    if (key < t->key) return node_copy(t, tree_replace(t->left, key, rule), node_retain(t->right));
+    return node_copy(t, node_retain(t->left), tree_replace(t->right, key, rule));
+}
+
+// In-order walk with an explicit stack
+typedef struct VersionIter {
+    const VersionNode **stack;
+    size_t depth, cap;
+} VersionIter;
+
+static void iter_descend(VersionIter *it, const VersionNode *n) {
+    for (; n; n = n->left) {
+        if (it->depth == it->cap) {
+            it->cap = it->cap ? it->cap * 2 : 64;
+            it->stack = (const VersionNode**)realloc(it->stack, it->cap * sizeof(VersionNode*));
+        }
+        it->stack[it->depth++] = n;
+    }
+}
+
+static const VersionNode *iter_next(VersionIter *it) {
+    if (it->depth == 0) return NULL;
+    const VersionNode *n = it->stack[--it->depth];
+    iter_descend(it, n->right);
+    return n;
+}
+
+/**
+ * Partage une version.
+ * @param v Version.
+ * @return Copie.
+ */
+BCVersion version_retain(const BCVersion *v) {
+    BCVersion copy = *v;
+    node_retain(copy.root);
+    return copy;
+}
+
+/**
+ * Libère une version.
+ * @param v Version.
+ * @return Aucun.
+ */
+void version_release(BCVersion *v) {
+    if (!v) return;
+    node_release(v->root);
+    memset(v, 0, sizeof(*v));
+}
+
+/**
+ * Parcourt les règles d'une version dans l'ordre de la base.
+ * @param v Version.
+ * @param visit Appelée pour chaque règle.
+ * @param arg Argument transmis à visit.
+ * @return Aucun.
+ */
+void version_foreach(const BCVersion *v,
+                     int (*visit)(void *arg, const Proposition *premises, uint32_t npremises,
+                                  const Proposition *conclusion),
+                     void *arg) {
+    if (!v || !visit) return;
+    VersionIter it;
+    memset(&it, 0, sizeof(it));
+    iter_descend(&it, v->root);
+    const VersionNode *n;
+    while ((n = iter_next(&it))) {
+        const VersionRule *r = n->rule;
+        if (visit(arg, r->premises, r->npremises, r->has_conclusion ? &r->conclusion : NULL)) break;
+    }
+    free(it.stack);
+}
+
+/**
+ * Compile une version.
+ * @param v Version.
+ * @return Base compilée.
+ */
+CompiledBC version_compile(const BCVersion *v) {
+    size_t n = 0;
+    RuleView *views = (RuleView*)malloc((v && v->nrules ? v->nrules : 1) * sizeof(RuleView));
+    VersionIter it;
+    memset(&it, 0, sizeof(it));
+    if (v) iter_descend(&it, v->root);
+    const VersionNode *node;
+    while ((node = iter_next(&it))) {
+        const VersionRule *r = node->rule;
+        if (!r->has_conclusion) continue;
+        views[n].premises = r->premises;
+        views[n].npremises = r->npremises;
+        views[n].conclusion = r->conclusion;
+        n++;
+    }
+    free(it.stack);
+    CompiledBC c = compiled_from_rules(views, n, v ? v->nsyms : 0);
+    free(views);
+    return c;
+}
+
+/**
+ * Range une règle ajoutée dans la version courante.
+ * @param v Version courante.
+ * @param node Nœud de la règle.
+ * @return Aucun.
+ */
+void version_add_rule(BCVersion *v, ListRegleNode *node) {
+    node->key = v->next_key++;
+    VersionNode *old = v->root;
+    v->root = tree_insert(old, node->key, key_prio(node->key), rule_from(&node->value));
+    node_release(old);
+    v->nrules++;
+}
+
+/**
+ * Retire une règle de la version courante.
+ * @param v Version courante.
+ * @param node Nœud de la règle.
+ * @return Aucun.
+ */
+void version_remove_rule(BCVersion *v, const ListRegleNode *node) {
+    VersionNode *old = v->root;
+    v->root = tree_erase(old, node->key);
+    node_release(old);
+    if (v->nrules > 0) v->nrules--;
+}
+
+/**
+ * Remplace le contenu d'une règle modifiée en place.
+ * @param v Version courante.
+ * @param node Nœud de la règle.
+ * @return Aucun.
+ */
+void version_update_rule(BCVersion *v, const ListRegleNode *node) {
+    VersionNode *old = v->root;
+    v->root = tree_replace(old, node->key, rule_from(&node->value));
+    node_release(old);
+}
+
+/**
+ * Active l'historique d'une base.
+ * @param bc Base de connaissances.
+ * @return Aucun.
+ */
+void bc_enable_versions(BC *bc) {
+    if (!bc || bc->current) return;
+    bc->current = (BCVersion*)calloc(1, sizeof(BCVersion));
+    // Keys arrive sorted: build the treap along its right spine in one pass
+    VersionNode **spine = (VersionNode**)malloc((bc->regles.size + 1) * sizeof(VersionNode*));
+    size_t depth = 0;
+    for (ListRegleNode *rn = bc->regles.head; rn; rn = rn->next) {
+        rn->key = bc->current->next_key++;
+        VersionNode *n = node_make(rn->key, key_prio(rn->key), NULL, NULL, rule_from(&rn->value));
+        VersionNode *last = NULL;
+        while (depth > 0 && spine[depth - 1]->prio < n->prio) last = spine[--depth];
+        n->left = last;
+        if (depth > 0) spine[depth - 1]->right = n;
+        spine[depth++] = n;
+        bc->current->nrules++;
+    }
+    bc->current->root = depth > 0 ? spine[0] : NULL;
+    free(spine);
+}
+
+/**
+ * Prend une version de la base.
+ * @param bc Base de connaissances.
+ * @return Version.
+ */
+BCVersion bc_snapshot(const BC *bc) {
+    BCVersion v;
+    memset(&v, 0, sizeof(v));
+    if (!bc || !bc->current) return v;
+    v = version_retain(bc->current);
+    v.nsyms = (size_t)symbol_count();
+    return v;
+}
+
+/**
+ * Remplace le contenu d'une base par une version.
+ * @param bc Base de connaissances.
+ * @param v Version à restaurer.
+ * @return Aucun.
+ */
+void bc_checkout(BC *bc, const BCVersion *v) {
+    if (!bc || !v) return;
+    // 'v' may be the base's own version: hold it across bc_free
+    BCVersion keep = version_retain(v);
+    bc_free(bc);
+    *bc = bc_create();
+    VersionIter it;
+    memset(&it, 0, sizeof(it));
+    iter_descend(&it, keep.root);
+    const VersionNode *n;
+    while ((n = iter_next(&it))) {
+        const VersionRule *vr = n->rule;
+        Regle r = regle_create_in(bc->arena);
+        for (uint32_t k = 0; k < vr->npremises; ++k) regle_add_premise(&r, vr->premises[k]);
+        if (vr->has_conclusion) regle_set_conclusion(&r, vr->conclusion);
+        bc_add_regle(bc, r);
+        bc->regles.tail->key = n->key;
+    }
+    free(it.stack);
+    bc->current = (BCVersion*)malloc(sizeof(BCVersion));
+    *bc->current = keep;
+}
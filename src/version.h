@@ -0,0 +1,111 @@
+#pragma once
+#include <stdint.h>
+#include "bc.h"
+#include "compiled.h"
+
+// Nœud d'une version (arbre persistant, voir version.c).
+typedef struct VersionNode VersionNode;
+
+// Version figée d'une base de connaissances. Les règles sont rangées dans
+// un arbre persistant (treap à clés croissantes, ordre de la base) dont les
+// nœuds et les règles sont partagés entre versions par comptage de
+// références: copier une version est en temps constant, et une
+// modification ne recopie que le chemin de la racine à la règle touchée.
+// Une version n'est jamais modifiée après coup: elle se lit sans verrou
+// depuis n'importe quel thread, et se libère depuis n'importe lequel.
+struct BCVersion {
+    VersionNode *root;
+    size_t nrules;
+    uint64_t next_key;   // clé de la prochaine règle ajoutée
+    size_t nsyms;        // symboles connus à la prise de la version
+};
+
+/**
+ * Active l'historique d'une base: ses règles sont rangées dans une version
+ * courante, tenue à jour ensuite par bc_add_regle et les suppressions
+ * (temps logarithmique attendu par règle touchée). Sans effet si déjà actif.
+ * @param bc Base de connaissances.
+ * @return Aucun.
+ */
+void bc_enable_versions(BC *bc);
+
+/**
+ * Prend une version de la base, en temps constant.
+ * @param bc Base dont l'historique est actif (bc_enable_versions).
+ * @return Version, à libérer avec version_release (vide si l'historique
+ *         n'est pas actif).
+ */
+BCVersion bc_snapshot(const BC *bc);
+
+/**
+ * Remplace le contenu d'une base par une version (annuler / rétablir). La
+ * version devient la version courante de la base; les règles sont
+ * reconstruites dans l'arène de la base (temps linéaire).
+ * @param bc Base dont l'historique est actif.
+ * @param v Version à restaurer (non modifiée).
+ * @return Aucun.
+ */
+void bc_checkout(BC *bc, const BCVersion *v);
+
+/**
+ * Partage une version (temps constant).
+ * @param v Version.
+ * @return Copie, à libérer avec version_release.
+ */
+BCVersion version_retain(const BCVersion *v);
+
+/**
+ * Libère une version; les nœuds encore partagés avec d'autres versions
+ * sont conservés.
+ * @param v Version.
+ * @return Aucun.
+ */
+void version_release(BCVersion *v);
+
+/**
+ * Parcourt les règles d'une version dans l'ordre de la base.
+ * @param v Version.
+ * @param visit Appelée pour chaque règle (conclusion NULL si la règle n'en
+ *        a pas); un retour non nul arrête le parcours.
+ * @param arg Argument transmis à visit.
+ * @return Aucun.
+ */
+void version_foreach(const BCVersion *v,
+                     int (*visit)(void *arg, const Proposition *premises, uint32_t npremises,
+                                  const Proposition *conclusion),
+                     void *arg);
+
+/**
+ * Compile une version (même format que bc_compile), sans lire la base ni
+ * la table des symboles: un thread lecteur peut compiler pendant que la
+ * base est modifiée.
+ * @param v Version.
+ * @return Base compilée, à libérer avec compiled_free.
+ */
+CompiledBC version_compile(const BCVersion *v);
+
+/**
+ * Range une règle ajoutée à la base dans sa version courante (appelée par
+ * bc_add_regle).
+ * @param v Version courante.
+ * @param node Nœud de la règle; reçoit sa clé.
+ * @return Aucun.
+ */
+void version_add_rule(BCVersion *v, ListRegleNode *node);
+
+/**
+ * Retire une règle de la version courante (appelée par les suppressions).
+ * @param v Version courante.
+ * @param node Nœud de la règle.
+ * @return Aucun.
+ */
+void version_remove_rule(BCVersion *v, const ListRegleNode *node);
+
+/**
+ * Remplace le contenu d'une règle modifiée en place (prémisses retirées par
+ * une cascade).
+ * @param v Version courante.
+ * @param node Nœud de la règle.
+ * @return Aucun.
+ */
+void version_update_rule(BCVersion *v, const ListRegleNode *node);
@@ -0,0 +1,207 @@
+#include <stdlib.h>
+#include <string.h>
+#include "worker.h"
+
+static int cancelled(InferenceWorker *w, unsigned long gen) {
+    return __atomic_load_n(&w->requested, __ATOMIC_ACQUIRE) != gen;
+}
+
+// Brings the session base to 'want' one fact at a time. Each step leaves
+// the session consistent, so a newer request can take over between two
+// steps and diff against whatever was applied so far.
+static int apply_delta(InferenceWorker *w, const BaseFaits *want, unsigned long gen) {
+    InferenceSession *s = &w->session;
+    size_t n = 0, cap = 16, it = 0;
+    Proposition *ops = (Proposition*)malloc(cap * sizeof(Proposition));
+    int *assert_op = (int*)malloc(cap * sizeof(int));
+    Proposition p;
+    for (int pass = 0; pass < 2; ++pass) {
+        // Retractions first, then assertions
+        const BaseFaits *from = pass == 0 ? &s->base : want;
+        const BaseFaits *other = pass == 0 ? want : &s->base;
+        it = 0;
+        while (facts_next(from, &it, &p)) {
+            if (facts_contains(other, &p)) continue;
+            if (n == cap) {
+                cap *= 2;
+                ops = (Proposition*)realloc(ops, cap * sizeof(Proposition));
+                assert_op = (int*)realloc(assert_op, cap * sizeof(int));
+            }
+            ops[n] = p;
+            assert_op[n++] = pass;
+        }
+    }
+    int done = 1;
+    for (size_t i = 0; i < n; ++i) {
+        if (cancelled(w, gen)) {
+            done = 0;
+            break;
+        }
+        if (assert_op[i]) session_assert(s, ops[i], NULL);
+        else session_retract(s, ops[i], NULL);
+    }
+    free(assert_op);
+    free(ops);
+    return done;
+}
+
+// Computes the closure for one request and publishes it unless a newer
+// request arrived meanwhile. Takes ownership of 'want' and 'version'.
+static void run_request(InferenceWorker *w, BaseFaits *want, BCVersion *version, unsigned long gen) {
+    if (version) {
+        // New base: compiled here from the frozen version, then one full
+        // closure, which no toggle can shorten
+        CompiledBC cbc = version_compile(version);
+        version_release(version);
+        if (w->has_session) session_free(&w->session);
+        w->session = session_create_compiled(cbc, want);
+        w->has_session = 1;
+    } else if (w->has_session && !apply_delta(w, want, gen)) {
+        facts_free(want);
+        return;
+    }
+    pthread_mutex_lock(&w->lock);
+    if (w->requested == gen) {
+        facts_free(&w->result);
+        w->result = w->has_session ? facts_copy(&w->session.facts) : facts_copy(want);
+        w->finished = gen;
+    }
+    pthread_mutex_unlock(&w->lock);
+    facts_free(want);
+}
+
+static void *worker_main(void *arg) {
+    InferenceWorker *w = (InferenceWorker*)arg;
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&w->lock);
+        while (!w->stop && w->requested == seen) pthread_cond_wait(&w->wake, &w->lock);
+        if (w->stop) {
+            pthread_mutex_unlock(&w->lock);
+            break;
+        }
+        seen = w->requested;
+        BaseFaits want = w->request;
+        w->request = facts_create();
+        BCVersion version;
+        int fresh = w->has_version;
+        if (fresh) {
+            version = w->next_version;
+            memset(&w->next_version, 0, sizeof(w->next_version));
+            w->has_version = 0;
+        }
+        pthread_mutex_unlock(&w->lock);
+        run_request(w, &want, fresh ? &version : NULL, seen);
+    }
+    return NULL;
+}
+
+/**
+ * Démarre un thread d'inférence.
+ * @return Thread démarré.
+ */
+InferenceWorker *inference_worker_create(void) {
+    InferenceWorker *w = (InferenceWorker*)calloc(1, sizeof(InferenceWorker));
+    w->request = facts_create();
+    w->result = facts_create();
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    // Without a thread, requests are served inline by inference_worker_post
+    w->started = pthread_create(&w->thread, NULL, worker_main, w) == 0;
+    return w;
+}
+
+/**
+ * Publie l'état voulu et revient sans attendre.
+ * @param w Thread d'inférence.
+ * @param version Version modifiée de la base (partagée), ou NULL.
+ * @param base Faits de base voulus (copiés).
+ * @return Génération de la requête.
+ */
+unsigned long inference_worker_post(InferenceWorker *w, const BCVersion *version, const BaseFaits *base) {
+    if (!w || !base) return 0;
+    BaseFaits want = facts_copy(base);
+
+    pthread_mutex_lock(&w->lock);
+    unsigned long gen = w->requested + 1;
+    if (version) {
+        // An unclaimed version is superseded by this one
+        if (w->has_version) version_release(&w->next_version);
+        w->next_version = version_retain(version);
+        w->has_version = 1;
+    }
+    if (!w->started) {
+        int fresh = w->has_version;
+        w->has_version = 0;
+        __atomic_store_n(&w->requested, gen, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&w->lock);
+        run_request(w, &want, fresh ? &w->next_version : NULL, gen);
+        return gen;
+    }
+    facts_free(&w->request);
+    w->request = want;
+    __atomic_store_n(&w->requested, gen, __ATOMIC_RELEASE);
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    return gen;
+}
+
+/**
+ * Récupère la dernière clôture terminée, si elle est nouvelle.
+ * @param w Thread d'inférence.
+ * @param out Base de faits remplacée par la clôture.
+ * @return 1 si out a été mise à jour, 0 sinon.
+ */
+int inference_worker_poll(InferenceWorker *w, BaseFaits *out) {
+    if (!w || !out) return 0;
+    int fresh = 0;
+    pthread_mutex_lock(&w->lock);
+    if (w->finished != w->taken) {
+        // Hand the closure over; the worker allocates a new one next time
+        facts_free(out);
+        *out = w->result;
+        w->result = facts_create();
+        w->taken = w->finished;
+        fresh = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return fresh;
+}
+
+/**
+ * Indique si la dernière requête est encore en calcul.
+ * @param w Thread d'inférence.
+ * @return 1 si une clôture plus récente est attendue, 0 sinon.
+ */
+int inference_worker_busy(InferenceWorker *w) {
+    if (!w) return 0;
+    pthread_mutex_lock(&w->lock);
+    int busy = w->finished != w->requested;
+    pthread_mutex_unlock(&w->lock);
+    return busy;
+}
+
+/**
+ * Arrête le thread et le libère.
+ * @param w Thread d'inférence.
+ * @return Aucun.
+ */
+void inference_worker_free(InferenceWorker *w) {
+    if (!w) return;
+    if (w->started) {
+        pthread_mutex_lock(&w->lock);
+        w->stop = 1;
+        // Also cancels a request being applied
+        __atomic_store_n(&w->requested, w->requested + 1, __ATOMIC_RELEASE);
+        pthread_cond_signal(&w->wake);
+        pthread_mutex_unlock(&w->lock);
+        pthread_join(w->thread, NULL);
+    }
+    if (w->has_version) version_release(&w->next_version);
+    if (w->has_session) session_free(&w->session);
+    facts_free(&w->request);
+    facts_free(&w->result);
+    pthread_cond_destroy(&w->wake);
+    pthread_mutex_destroy(&w->lock);
+    free(w);
+}
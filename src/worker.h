@@ -0,0 +1,73 @@
+#pragma once
+#include <pthread.h>
+#include "bc.h"
+#include "compiled.h"
+#include "inference.h"
+#include "session.h"
+#include "version.h"
+
+// Thread d'inférence en arrière-plan pour une interface interactive. Le
+// thread appelant publie l'état voulu (faits de base, et au besoin une
+// nouvelle version de la base, compilée par le thread de travail) puis
+// reprend la main aussitôt; le thread de travail le rejoint par deltas sur
+// une session incrémentale et publie une copie de la clôture. Une requête
+// plus récente annule la précédente entre deux deltas: seule la dernière
+// est menée à terme.
+typedef struct InferenceWorker {
+    pthread_t thread;
+    int started;             // 0: pas de thread, calcul fait dans post
+    InferenceSession session; // propre au thread de travail
+    int has_session;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;     // nouvelle requête ou arrêt
+    // Dernière requête (sous verrou)
+    BaseFaits request;       // faits de base voulus
+    BCVersion next_version;  // nouvelle version de la base à adopter
+    int has_version;
+    unsigned long requested; // génération de la dernière requête (lue sans verrou pour annuler)
+    // Dernière clôture terminée (sous verrou)
+    BaseFaits result;
+    unsigned long finished;  // génération de result
+    unsigned long taken;     // génération déjà rendue par inference_worker_poll
+    int stop;
+} InferenceWorker;
+
+/**
+ * Démarre un thread d'inférence. Aucune clôture n'est calculée avant la
+ * première requête accompagnée d'une base.
+ * @return Thread démarré, à libérer avec inference_worker_free.
+ */
+InferenceWorker *inference_worker_create(void);
+
+/**
+ * Publie l'état voulu et revient sans attendre. Une requête encore en
+ * cours est abandonnée au profit de celle-ci.
+ * @param w Thread d'inférence.
+ * @param version Version modifiée de la base (partagée: l'appelant peut
+ *        continuer à modifier la base), ou NULL si elle n'a pas changé.
+ * @param base Faits de base voulus (copiés).
+ * @return Génération de la requête.
+ */
+unsigned long inference_worker_post(InferenceWorker *w, const BCVersion *version, const BaseFaits *base);
+
+/**
+ * Récupère la dernière clôture terminée, si elle n'a pas déjà été rendue.
+ * @param w Thread d'inférence.
+ * @param out Base de faits remplacée par la clôture (l'ancienne est libérée).
+ * @return 1 si out a été mise à jour, 0 sinon.
+ */
+int inference_worker_poll(InferenceWorker *w, BaseFaits *out);
+
+/**
+ * Indique si la dernière requête est encore en calcul.
+ * @param w Thread d'inférence.
+ * @return 1 si une clôture plus récente est attendue, 0 sinon.
+ */
+int inference_worker_busy(InferenceWorker *w);
+
+/**
+ * Arrête le thread (en abandonnant une requête en cours) et le libère.
+ * @param w Thread d'inférence.
+ * @return Aucun.
+ */
+void inference_worker_free(InferenceWorker *w);